@@ -5,22 +5,24 @@ CameraManager = {
 }
 
 function CameraManager:OnUpdate()
-	local player_actor = Actor.Find("player")
+	-- Keep the handle between frames rather than repeat the name lookup every frame
+	if self.player_actor == nil or not self.player_actor:IsValid() then
+		self.player_actor = Actor.Find("player")
+	end
+	local player_actor = self.player_actor
 	if player_actor == nil then
 		self.tracking_player = false
 		return
 	elseif self.tracking_player == false then
 		self.tracking_player = true
 		local rb = player_actor:GetComponent("Rigidbody") --[[@as Rigidbody]]
-		local player_pos = rb:GetPosition()
-		Camera.SetPosition(player_pos.x, player_pos.y)
+		Camera.SetPosition(rb:GetPositionXY())
 		return
 	end
 
 	local player_rb = player_actor:GetComponent("Rigidbody") --[[@as Rigidbody]]
-	local desired_position = player_rb:GetPosition()
-	local current_position = Vector2(Camera.GetPositionX(), Camera.GetPositionY())
+	local desired_x, desired_y = player_rb:GetPositionXY()
+	local current_x, current_y = Camera.GetPositionX(), Camera.GetPositionY()
 
-	local new_position = current_position + (desired_position - current_position) * self.ease_factor
-	Camera.SetPosition(new_position.x, new_position.y)
+	Camera.SetPosition(current_x + (desired_x - current_x) * self.ease_factor, current_y + (desired_y - current_y) * self.ease_factor)
 end
@@ -22,13 +22,13 @@ function KeyboardControls:OnUpdate()
 	-- Vertical
 	local vertical_input = 0
 
-	-- Check on ground
-	local ground_object = Physics.Raycast(self.rb:GetPosition(), Vector2(0, 1), 1)
 	if Input.GetKeyDown("up") or Input.GetKeyDown("space") then
+		-- Check on ground only when jumping, since the ray's vectors and hit result are allocated
+		local ground_object = Physics.Raycast(self.rb:GetPosition(), Vector2(0, 1), 1)
 		if ground_object ~= nil then
 			vertical_input = -self.jump_power
 		end
 	end
 
-	self.rb:AddForce(Vector2(horizontal_input, vertical_input))
+	self.rb:AddForceXY(horizontal_input, vertical_input)
 end
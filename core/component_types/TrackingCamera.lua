@@ -8,9 +8,8 @@ function TrackingCamera:OnUpdate()
 	if rb == nil then
 		return
 	end
-	local desired_position = rb:GetPosition()
-	local current_position = Vector2(Camera.GetPositionX(), Camera.GetPositionY())
+	local desired_x, desired_y = rb:GetPositionXY()
+	local current_x, current_y = Camera.GetPositionX(), Camera.GetPositionY()
 
-	local new_position = current_position + (desired_position - current_position) * self.ease_factor
-	Camera.SetPosition(new_position.x, new_position.y)
+	Camera.SetPosition(current_x + (desired_x - current_x) * self.ease_factor, current_y + (desired_y - current_y) * self.ease_factor)
 end
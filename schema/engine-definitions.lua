@@ -43,6 +43,21 @@ function Vector2:Normalize() end
 ---@return number
 function Vector2:Length() end
 
+---The in-place methods below modify this vector rather than allocating a new one like + - * do
+
+---@param x number
+---@param y number
+function Vector2:Set(x, y) end
+
+---@param other Vector2
+function Vector2:Add(other) end
+
+---@param other Vector2
+function Vector2:Sub(other) end
+
+---@param factor number
+function Vector2:Scale(factor) end
+
 ---@param a Vector2
 ---@param b Vector2
 ---@return Vector2
@@ -143,6 +158,151 @@ function Rigidbody:SetUpDirection(up_direction) end
 ---@param right_direction Vector2
 function Rigidbody:SetRightDirection(right_direction) end
 
+---The XY variants below take and return plain numbers instead of Vector2, so they allocate nothing
+
+---@return number x, number y
+function Rigidbody:GetPositionXY() end
+
+---@return number x, number y
+function Rigidbody:GetVelocityXY() end
+
+---@return number x, number y
+function Rigidbody:GetUpDirectionXY() end
+
+---@return number x, number y
+function Rigidbody:GetRightDirectionXY() end
+
+---@param x number
+---@param y number
+function Rigidbody:AddForceXY(x, y) end
+
+---@param x number
+---@param y number
+function Rigidbody:AddLinearImpulseXY(x, y) end
+
+---@param x number
+---@param y number
+function Rigidbody:SetVelocityXY(x, y) end
+
+---@param x number
+---@param y number
+function Rigidbody:SetPositionXY(x, y) end
+
+
+---Static collision for a whole LDtk tile layer, added to the layer's "__tiles_<identifier>" actor
+---@class TilemapCollider: Component
+---@field type string
+---@field key string
+---@field actor Actor
+---@field enabled boolean
+---@field friction number
+---@field bounciness number
+
+
+---Draws a region of a tileset each frame, following the actor's Rigidbody if it has one.
+---Nothing is drawn while the tile is outside the camera view; without a Rigidbody the tile is
+---kept in a spatial grid and off-screen tiles are not visited at all
+---@class TileRenderer: Component
+---@field type string
+---@field key string
+---@field actor Actor
+---@field enabled boolean
+---@field tileset string
+---Position used when the actor has no Rigidbody
+---@field x number
+---@field y number
+---@field w number
+---@field h number
+---Source rectangle within the tileset, in pixels
+---@field tx number
+---@field ty number
+---@field tw number
+---@field th number
+---Flip horizontally
+---@field tfx boolean
+---Flip vertically
+---@field tfy boolean
+---@field r number
+---@field g number
+---@field b number
+---@field a number
+---@field sorting_order number
+
+
+---Draws an image each frame, following the actor's Rigidbody if it has one.
+---Culled against the camera view the same way as TileRenderer
+---@class SpriteRenderer: Component
+---@field type string
+---@field key string
+---@field actor Actor
+---@field enabled boolean
+---@field sprite string
+---Position used when the actor has no Rigidbody
+---@field x number
+---@field y number
+---@field w number
+---@field h number
+---@field r number
+---@field g number
+---@field b number
+---@field a number
+---@field sorting_order number
+
+
+---Emits bursts of images every few frames, simulated natively. Particles move in world units per frame.
+---Color and scale interpolate from their start to end values over a particle's life; negative end values keep the start value
+---@class ParticleSystem: Component
+---@field type string
+---@field key string
+---@field actor Actor
+---@field enabled boolean
+---@field image string
+---Emitter position
+---@field x number
+---@field y number
+---@field sorting_order number
+---@field frames_between_bursts integer
+---@field burst_quantity integer
+---Lifetime of each particle in frames
+---@field duration_frames integer
+---@field emit_angle_min number
+---@field emit_angle_max number
+---@field emit_radius_min number
+---@field emit_radius_max number
+---@field start_speed_min number
+---@field start_speed_max number
+---@field rotation_min number
+---@field rotation_max number
+---@field rotation_speed_min number
+---@field rotation_speed_max number
+---Added to each particle's velocity every frame
+---@field gravity_scale_x number
+---@field gravity_scale_y number
+---Velocity multiplier applied every frame
+---@field drag_factor number
+---@field angular_drag_factor number
+---@field start_scale_min number
+---@field start_scale_max number
+---@field end_scale number
+---@field start_color_r number
+---@field start_color_g number
+---@field start_color_b number
+---@field start_color_a number
+---@field end_color_r number
+---@field end_color_g number
+---@field end_color_b number
+---@field end_color_a number
+local ParticleSystem = {}
+
+---Resumes emitting bursts
+function ParticleSystem:Play() end
+
+---Stops emitting bursts; live particles finish their lifetime
+function ParticleSystem:Stop() end
+
+---Emits one burst immediately
+function ParticleSystem:Burst() end
+
 
 ---@class Collision
 ---@field other Actor
@@ -170,10 +330,74 @@ function Debug.Log(msg) end
 ---@param msg string
 function Debug.LogError(msg) end
 
-
+---@class ComponentStats
+---@field calls number
+---@field time_ms number
+---@field alloc_bytes number
+
+---@class ActorStats: ComponentStats
+---@field id number
+---@field name string
+
+---@class HeapStats
+---@field live_bytes number
+---@field live_blocks number
+---Memory reserved by the allocator's small-block pools
+---@field pool_bytes number
+---Bytes and blocks allocated during the last frame
+---@field frame_alloc_bytes number
+---@field frame_allocs number
+---"incremental" or "generational", from game.config
+---@field gc_mode string
+---Time spent in and steps taken by the engine-driven collector after the last frame
+---@field gc_ms number
+---@field gc_steps number
+---Collections completed since startup: full cycles in incremental mode, young or major
+---collections in generational mode
+---@field gc_collections number
+
+---@class FrameStats
+---@field enabled boolean
+---@field time_ms number
+---@field alloc_bytes number
+---@field components table<string, ComponentStats>
+---Sorted by descending time_ms
+---@field actors ActorStats[]
+---Tracked even while stats are disabled
+---@field heap HeapStats
+
+---Returns the OnUpdate/OnLateUpdate cost of the last completed frame, per component type and per actor
+---@return FrameStats
+function Debug.GetStats() end
+
+---Turns per-component cost accounting on or off
+---@param enabled boolean
+function Debug.EnableStats(enabled) end
+
+---@class BindingBenchmark
+---@field luabridge_ms number
+---@field raw_ms number
+
+---Calls each hot engine binding in a Lua loop, once through LuaBridge's generic dispatch and once through
+---the direct binding the engine registers, and prints the timings. Pass an actor and a component type to
+---include actor:GetComponent
+---@param iterations? number defaults to 1000000
+---@param actor? Actor
+---@param type_name? string
+---@return table<string, BindingBenchmark>
+function Debug.BenchmarkBindings(iterations, actor, type_name) end
+
+
+---A handle to an actor. Once the actor is destroyed the handle goes stale: GetName returns "",
+---GetID returns -1 and the component getters return nil
+---Every lookup of a live actor returns the same handle, so handles compare and key tables by identity
 ---@class Actor
 Actor = {}
 
+---False once the actor has been destroyed and released
+---@return boolean
+function Actor:IsValid() end
+
 ---@return string
 function Actor:GetName() end
 
@@ -210,6 +434,7 @@ function Actor.FindAll(name) end
 ---@return Actor
 function Actor.Instantiate(template_name) end
 
+---Does nothing for a stale handle or an actor already destroyed
 ---@param actor Actor
 function Actor.Destroy(actor) end
 
@@ -281,6 +506,22 @@ Text = {}
 ---@param a number
 function Text.Draw(text, x, y, font_name, font_size, r, g, b, a) end
 
+---Returns a handle for a font at one size, for use with Text.DrawById
+---@param font_name string
+---@param font_size number
+---@return integer
+function Text.Load(font_name, font_size) end
+
+---@param text string
+---@param x number
+---@param y number
+---@param font integer handle from Text.Load
+---@param r number
+---@param g number
+---@param b number
+---@param a number
+function Text.DrawById(text, x, y, font, r, g, b, a) end
+
 
 ---@class Audio
 Audio = {}
@@ -290,6 +531,16 @@ Audio = {}
 ---@param does_loop boolean
 function Audio.PlayAudio(channel, audio_name, does_loop) end
 
+---Loads a clip and returns a handle for Audio.PlayById
+---@param audio_name string
+---@return integer
+function Audio.Load(audio_name) end
+
+---@param channel number
+---@param audio integer handle from Audio.Load
+---@param does_loop boolean
+function Audio.PlayById(channel, audio, does_loop) end
+
 ---@param channel number
 function Audio.HaltAudio(channel) end
 
@@ -301,11 +552,21 @@ function Audio.SetVolume(channel, volume) end
 ---@class Image
 Image = {}
 
+---Returns a handle for an image or tileset, accepted by the *ById draw functions
+---@param image_name string
+---@return integer
+function Image.Load(image_name) end
+
 ---@param image_name string
 ---@param x number
 ---@param y number
 function Image.DrawUI(image_name, x, y) end
 
+---@param image integer handle from Image.Load
+---@param x number
+---@param y number
+function Image.DrawUIById(image, x, y) end
+
 ---@param image_name string
 ---@param x number
 ---@param y number
@@ -321,11 +582,31 @@ function Image.DrawUI(image_name, x, y) end
 ---@param sorting_order number
 function Image.DrawUIEx(image_name, x, y, rotation_degrees, scale_x, scale_y, pivot_x, pivot_y, r, g, b, a, sorting_order) end
 
+---@param image integer handle from Image.Load
+---@param x number
+---@param y number
+---@param rotation_degrees number
+---@param scale_x number
+---@param scale_y number
+---@param pivot_x number
+---@param pivot_y number
+---@param r number
+---@param g number
+---@param b number
+---@param a number
+---@param sorting_order number
+function Image.DrawUIExById(image, x, y, rotation_degrees, scale_x, scale_y, pivot_x, pivot_y, r, g, b, a, sorting_order) end
+
 ---@param image_name string
 ---@param x number
 ---@param y number
 function Image.Draw(image_name, x, y) end
 
+---@param image integer handle from Image.Load
+---@param x number
+---@param y number
+function Image.DrawById(image, x, y) end
+
 ---@param image_name string
 ---@param x number
 ---@param y number
@@ -341,6 +622,28 @@ function Image.Draw(image_name, x, y) end
 ---@param sorting_order number
 function Image.DrawEx(image_name, x, y, rotation_degrees, scale_x, scale_y, pivot_x, pivot_y, r, g, b, a, sorting_order) end
 
+---@param image integer handle from Image.Load
+---@param x number
+---@param y number
+---@param rotation_degrees number
+---@param scale_x number
+---@param scale_y number
+---@param pivot_x number
+---@param pivot_y number
+---@param r number
+---@param g number
+---@param b number
+---@param a number
+---@param sorting_order number
+function Image.DrawExById(image, x, y, rotation_degrees, scale_x, scale_y, pivot_x, pivot_y, r, g, b, a, sorting_order) end
+
+---Queues many scene images in one call. Every 10 values of buffer describe one image:
+---x, y, rotation_degrees, scale_x, scale_y, r, g, b, a, sorting_order
+---buffer is either a flat array of numbers or a string of packed floats, e.g. string.pack("ffffffffff", ...)
+---@param image string|integer image name or handle from Image.Load
+---@param buffer number[]|string
+function Image.DrawBatch(image, buffer) end
+
 ---@param tileset_name string
 ---@param tile_x number
 ---@param tile_y number
@@ -350,6 +653,15 @@ function Image.DrawEx(image_name, x, y, rotation_degrees, scale_x, scale_y, pivo
 ---@param y number
 function Image.DrawTile(tileset_name, tile_x, tile_y, tile_w, tile_h, x, y) end
 
+---@param tileset integer handle from Image.Load
+---@param tile_x number
+---@param tile_y number
+---@param tile_w number
+---@param tile_h number
+---@param x number
+---@param y number
+function Image.DrawTileById(tileset, tile_x, tile_y, tile_w, tile_h, x, y) end
+
 ---@param tileset_name string
 ---@param tile_x number
 ---@param tile_y number
@@ -371,7 +683,29 @@ function Image.DrawTile(tileset_name, tile_x, tile_y, tile_w, tile_h, x, y) end
 ---@param sorting_order number
 function Image.DrawTileEx(tileset_name, tile_x, tile_y, tile_w, tile_h, x, y, w, h, rotation_degrees, scale_x, scale_y, pivot_x, pivot_y, r, g, b, a, sorting_order) end
 
+---@param tileset integer handle from Image.Load
+---@param tile_x number
+---@param tile_y number
+---@param tile_w number
+---@param tile_h number
+---@param x number
+---@param y number
+---@param w number
+---@param h number
+---@param rotation_degrees number
+---@param scale_x number
+---@param scale_y number
+---@param pivot_x number
+---@param pivot_y number
+---@param r number
+---@param g number
+---@param b number
+---@param a number
+---@param sorting_order number
+function Image.DrawTileExById(tileset, tile_x, tile_y, tile_w, tile_h, x, y, w, h, rotation_degrees, scale_x, scale_y, pivot_x, pivot_y, r, g, b, a, sorting_order) end
+
 
+---Blends a pixel in screen coordinates into the pixel layer, which is drawn over everything else
 ---@param x number
 ---@param y number
 ---@param r number
@@ -400,6 +734,14 @@ function Camera.SetZoom(zoom) end
 ---@return number
 function Camera.GetZoom() end
 
+---Whether a rectangle centered on (x, y) overlaps the camera view, taking zoom into account
+---@param x number
+---@param y number
+---@param w number width in world units
+---@param h number height in world units
+---@return boolean
+function Camera.IsVisible(x, y, w, h) end
+
 
 ---@class Scene
 Scene = {}
@@ -1,7 +1,9 @@
 #include "Actor.h"
 
+#include "ActorStore.h"
 #include "ComponentDB.h"
 #include "Engine.h"
+#include "TilemapCollider.h"
 
 auto Actor::ParseActor(const rapidjson::Value &val) -> void {
     for (const auto &[actor_key, actor_val] : val.GetObject()) {
@@ -125,42 +127,16 @@ auto Actor::ParseLdtkEntity(const int layer, const std::unordered_map<int64_t, s
     }
 }
 
-auto Actor::ParseLdtkTile(const int layer, const std::string &tileset, const double opacity, const int64_t grid_size, const bool bg, const ldtk::TileInstance &tile, const std::string &name) -> void {
+auto Actor::ParseLdtkTilemapCollider(const std::shared_ptr<TilemapLayer> &layer, const std::string &name) -> void {
     actor_name = name;
-    const auto &src = tile.get_src();
-    const auto &px = tile.get_px();
-    const auto &f = tile.get_f();
-    auto tile_renderer_doc = rapidjson::Document();
-    tile_renderer_doc.Parse("{\"tile_renderer\": {\"type\": \"TileRenderer\"}}");
-    auto &tile_renderer_allocator = tile_renderer_doc.GetAllocator();
-    auto &tile_renderer = tile_renderer_doc["tile_renderer"];
-    tile_renderer.AddMember("tileset", tileset, tile_renderer_allocator);
-    tile_renderer.AddMember("x", (px[0] + grid_size / 2) / static_cast<float>(Engine::config.pixels_per_meter), tile_renderer_allocator);
-    tile_renderer.AddMember("y", (px[1] + grid_size / 2) / static_cast<float>(Engine::config.pixels_per_meter), tile_renderer_allocator);
-    tile_renderer.AddMember("w", grid_size, tile_renderer_allocator);
-    tile_renderer.AddMember("h", grid_size, tile_renderer_allocator);
-    tile_renderer.AddMember("tx", src[0], tile_renderer_allocator);
-    tile_renderer.AddMember("ty", src[1], tile_renderer_allocator);
-    tile_renderer.AddMember("tw", grid_size, tile_renderer_allocator);
-    tile_renderer.AddMember("th", grid_size, tile_renderer_allocator);
-    tile_renderer.AddMember("tfx", f & 1 ? true : false, tile_renderer_allocator);
-    tile_renderer.AddMember("tfy", f & 2 ? true : false, tile_renderer_allocator);
-    tile_renderer.AddMember("a", static_cast<int>(opacity * 255), tile_renderer_allocator);
-    tile_renderer.AddMember("sorting_order", -layer, tile_renderer_allocator);
-    ParseComponents(tile_renderer_doc);
-    if (!bg) {
-        auto rigidbody_doc = rapidjson::Document();
-        rigidbody_doc.Parse("{\"rb\": {\"type\": \"Rigidbody\", \"body_type\": \"static\"}}");
-        auto &rigidbody_allocator = rigidbody_doc.GetAllocator();
-        auto &rigidbody = rigidbody_doc["rb"];
-        rigidbody.AddMember("x", (px[0] + grid_size / 2) / static_cast<float>(Engine::config.pixels_per_meter), rigidbody_allocator);
-        rigidbody.AddMember("y", (px[1] + grid_size / 2) / static_cast<float>(Engine::config.pixels_per_meter), rigidbody_allocator);
-        rigidbody.AddMember("friction", Engine::config.default_tile_friction, rigidbody_allocator);
-        rigidbody.AddMember("bounciness", Engine::config.default_tile_bounciness, rigidbody_allocator);
-        rigidbody.AddMember("width", grid_size / static_cast<float>(Engine::config.pixels_per_meter), rigidbody_allocator);
-        rigidbody.AddMember("height", grid_size / static_cast<float>(Engine::config.pixels_per_meter), rigidbody_allocator);
-        ParseComponents(rigidbody_doc);
-    }
+    auto collider_doc = rapidjson::Document();
+    collider_doc.Parse("{\"collider\": {\"type\": \"TilemapCollider\"}}");
+    auto &collider_allocator = collider_doc.GetAllocator();
+    auto &collider = collider_doc["collider"];
+    collider.AddMember("friction", Engine::config.default_tile_friction, collider_allocator);
+    collider.AddMember("bounciness", Engine::config.default_tile_bounciness, collider_allocator);
+    ParseComponents(collider_doc);
+    static_cast<TilemapCollider *>(components.at("collider").native)->layer = layer;
 }
 
 auto Actor::GetName() -> std::string {
@@ -179,12 +155,19 @@ auto Actor::GetComponentByKey(const char *key) -> luabridge::LuaRef {
 }
 
 auto Actor::GetComponent(const char *type) -> luabridge::LuaRef {
-    if (const auto it = type_to_components.find(type); it != type_to_components.end() && !it->second.empty() && (*it->second.begin())->IsEnabled()) {
-        return *(*it->second.begin())->ref;
+    if (const auto component = FindComponent(type); component != nullptr) {
+        return *component->ref;
     }
     return luabridge::LuaRef(LuaDB::GetLuaState());
 }
 
+auto Actor::FindComponent(const char *type) -> Component * {
+    if (const auto it = type_to_components.find(type); it != type_to_components.end() && !it->second.empty() && (*it->second.begin())->IsEnabled()) {
+        return *it->second.begin();
+    }
+    return nullptr;
+}
+
 auto Actor::GetComponents(const char *type) -> luabridge::LuaRef {
     const auto found_components = luabridge::newTable(LuaDB::GetLuaState());
     if (const auto it = type_to_components.find(type); it != type_to_components.end()) {
@@ -200,7 +183,11 @@ auto Actor::GetComponents(const char *type) -> luabridge::LuaRef {
 }
 
 auto Actor::InjectConvenienceReferences(Component &component) -> void {
-    (*component.ref)["actor"] = this;
+    if (component.native_actor != nullptr) {
+        *component.native_actor = this;
+        return;
+    }
+    (*component.ref)["actor"] = ActorStore::GetHandle(this);
 }
 
 auto Actor::Copy() const -> Actor {
@@ -261,14 +248,11 @@ auto Actor::AddComponent(const char *type) -> luabridge::LuaRef { // move to que
 }
 
 auto Actor::RemoveComponent(luabridge::LuaRef ref) -> void {
-    if (auto component = FindComponentByRef(ref); component != nullptr) {
-        const auto it = std::find(add_component_queue.begin(), add_component_queue.end(), component);
-        if (it != add_component_queue.end()) {
-            add_component_queue.erase(it);
-        }
+    if (auto component = FindComponentByRef(ref); component != nullptr && !component->removed) {
+        component->removed = true;
         component->SetEnabled(false);
         if (component->hasDestroy) {
-            Engine::scene.destroy_queue.insert(component);
+            Engine::scene.destroy_queue.Insert(component);
         }
         type_to_components[component->type].erase(component);
         if (component->hasOnCollisionEnter) {
@@ -289,6 +273,10 @@ auto Actor::RemoveComponent(luabridge::LuaRef ref) -> void {
 
 auto Actor::FinishAddingComponents() -> void {
     for (const auto component : add_component_queue) {
+        // Removed again, or added to an actor that was destroyed this frame and is about to be released
+        if (component->removed || Engine::scene.id_to_actors.find(component->actor_id) == Engine::scene.id_to_actors.end()) {
+            continue;
+        }
         Engine::scene.RegisterComponent(*component);
     }
     add_component_queue.clear();
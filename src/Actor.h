@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <map>
+#include <memory>
 #include <set>
 #include <unordered_map>
 
@@ -11,6 +13,8 @@
 #include "Component.h"
 #include "LuaDB.h"
 
+class TilemapLayer;
+
 class ComponentCmp {
   public:
     bool operator()(const Component *a, const Component *b) const {
@@ -30,12 +34,19 @@ class Actor {
     std::map<std::string, Component *> trigger_exit_components;
     size_t id = 0;
     bool persistent = false;
+    // Positions in Scene::actors and this name's bucket, so removal never has to search
+    size_t scene_slot = 0;
+    size_t name_slot = 0;
+    // Instantiated this frame and still waiting in Scene::add_actor_queue
+    bool pending_add = false;
+    // Index in ActorStore, which also goes into box2d fixture user data
+    uint32_t store_slot = 0;
 
     auto ParseActor(const rapidjson::Value &) -> void;
 
     auto ParseLdtkEntity(const int, const std::unordered_map<int64_t, std::string> &, const double, const ldtk::EntityInstance &) -> void;
 
-    auto ParseLdtkTile(const int, const std::string &, const double, const int64_t, const bool, const ldtk::TileInstance &, const std::string &) -> void;
+    auto ParseLdtkTilemapCollider(const std::shared_ptr<TilemapLayer> &, const std::string &) -> void;
 
     auto GetName() -> std::string;
 
@@ -45,6 +56,9 @@ class Actor {
 
     auto GetComponent(const char *) -> luabridge::LuaRef;
 
+    // The first enabled component of a type, or null
+    auto FindComponent(const char *) -> Component *;
+
     auto GetComponents(const char *) -> luabridge::LuaRef;
 
     auto InjectConvenienceReferences(Component &) -> void;
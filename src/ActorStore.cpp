@@ -0,0 +1,148 @@
+#include "ActorStore.h"
+
+#include "LuaBinding.h"
+
+auto ActorHandle::Get() const -> Actor * {
+    return ActorStore::Resolve(*this);
+}
+
+auto ActorHandle::operator==(const ActorHandle &other) const -> bool {
+    return slot == other.slot && generation == other.generation;
+}
+
+auto ActorHandle::IsValid() const -> bool {
+    return Get() != nullptr;
+}
+
+auto ActorHandle::GetName() const -> std::string {
+    const auto actor = Get();
+    return actor != nullptr ? actor->GetName() : "";
+}
+
+auto ActorHandle::GetID() const -> int {
+    const auto actor = Get();
+    return actor != nullptr ? actor->GetID() : -1;
+}
+
+auto ActorHandle::GetComponentByKey(const char *key) const -> luabridge::LuaRef {
+    if (const auto actor = Get(); actor != nullptr) {
+        return actor->GetComponentByKey(key);
+    }
+    return luabridge::LuaRef(LuaDB::GetLuaState());
+}
+
+auto ActorHandle::GetComponent(const char *type) const -> luabridge::LuaRef {
+    if (const auto actor = Get(); actor != nullptr) {
+        return actor->GetComponent(type);
+    }
+    return luabridge::LuaRef(LuaDB::GetLuaState());
+}
+
+auto ActorHandle::PushComponent(lua_State *lua_state) const -> int {
+    const auto type = luaL_checkstring(lua_state, 2);
+    const auto actor = Get();
+    const auto component = actor != nullptr ? actor->FindComponent(type) : nullptr;
+    if (component == nullptr) {
+        lua_pushnil(lua_state);
+    } else {
+        component->ref->push(lua_state);
+    }
+    return 1;
+}
+
+auto ActorHandle::GetComponents(const char *type) const -> luabridge::LuaRef {
+    if (const auto actor = Get(); actor != nullptr) {
+        return actor->GetComponents(type);
+    }
+    return luabridge::newTable(LuaDB::GetLuaState());
+}
+
+auto ActorHandle::AddComponent(const char *type) const -> luabridge::LuaRef {
+    if (const auto actor = Get(); actor != nullptr) {
+        return actor->AddComponent(type);
+    }
+    return luabridge::LuaRef(LuaDB::GetLuaState());
+}
+
+auto ActorHandle::RemoveComponent(luabridge::LuaRef ref) const -> void {
+    if (const auto actor = Get(); actor != nullptr) {
+        actor->RemoveComponent(ref);
+    }
+}
+
+auto ActorStore::Create(Actor &&actor) -> Actor * {
+    auto slot = uint32_t{0};
+    if (free_slots.empty()) {
+        slot = static_cast<uint32_t>(slots.size());
+        slots.push_back(std::move(actor));
+        generations.push_back(0);
+        live.push_back(true);
+        lua_refs.push_back(LUA_NOREF);
+    } else {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        slots[slot] = std::move(actor);
+        live[slot] = true;
+    }
+    slots[slot].store_slot = slot;
+    return &slots[slot];
+}
+
+auto ActorStore::Release(Actor *actor) -> void {
+    const auto slot = actor->store_slot;
+    // Native storage goes back to its pool. Scripts may still hold the component, so its userdata is
+    // moved to a detached instance before the storage is reused
+    const auto lua_state = LuaDB::GetLuaState();
+    for (auto &[key, component] : actor->components) {
+        if (component.native_recycle != nullptr) {
+            component.ref->push(lua_state);
+            LuaBinding::SetObject(lua_state, -1, component.native_recycle(component.native));
+            lua_pop(lua_state, 1);
+        }
+    }
+    slots[slot] = Actor{};
+    generations[slot]++;
+    // Lua keeps any copies it still holds; they now carry a stale generation
+    if (lua_refs[slot] != LUA_NOREF) {
+        luaL_unref(LuaDB::GetLuaState(), LUA_REGISTRYINDEX, lua_refs[slot]);
+        lua_refs[slot] = LUA_NOREF;
+    }
+    live[slot] = false;
+    free_slots.push_back(slot);
+}
+
+auto ActorStore::GetHandle(const Actor *actor) -> ActorHandle {
+    if (actor == nullptr) {
+        return ActorHandle{};
+    }
+    return ActorHandle{actor->store_slot, generations[actor->store_slot]};
+}
+
+auto ActorStore::Resolve(const ActorHandle &handle) -> Actor * {
+    if (handle.slot >= slots.size() || !live[handle.slot] || generations[handle.slot] != handle.generation) {
+        return nullptr;
+    }
+    return &slots[handle.slot];
+}
+
+auto ActorStore::ResolveSlot(uint32_t slot) -> Actor * {
+    if (slot >= slots.size() || !live[slot]) {
+        return nullptr;
+    }
+    return &slots[slot];
+}
+
+auto ActorStore::Push(lua_State *lua_state, const ActorHandle &handle) -> void {
+    if (Resolve(handle) == nullptr) {
+        luabridge::detail::UserdataValue<ActorHandle>::push(lua_state, handle);
+        return;
+    }
+    auto &ref = lua_refs[handle.slot];
+    if (ref != LUA_NOREF) {
+        lua_rawgeti(lua_state, LUA_REGISTRYINDEX, ref);
+        return;
+    }
+    luabridge::detail::UserdataValue<ActorHandle>::push(lua_state, handle);
+    lua_pushvalue(lua_state, -1);
+    ref = luaL_ref(lua_state, LUA_REGISTRYINDEX);
+}
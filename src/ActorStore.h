@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "Actor.h"
+#include "LuaDB.h"
+
+// What Lua holds instead of an Actor pointer. Once the actor is destroyed its slot's generation moves on,
+// so the handle stops resolving rather than pointing at whatever reuses the slot
+class ActorHandle {
+  public:
+    uint32_t slot = std::numeric_limits<uint32_t>::max();
+    uint32_t generation = 0;
+
+    auto Get() const -> Actor *;
+
+    auto operator==(const ActorHandle &) const -> bool;
+
+    // Lua API, forwarded to the actor; a stale handle reads as an empty actor
+    auto IsValid() const -> bool;
+
+    auto GetName() const -> std::string;
+
+    auto GetID() const -> int;
+
+    auto GetComponentByKey(const char *) const -> luabridge::LuaRef;
+
+    auto GetComponent(const char *) const -> luabridge::LuaRef;
+
+    // GetComponent as a raw binding, pushing the component without a LuaRef temporary
+    auto PushComponent(lua_State *) const -> int;
+
+    auto GetComponents(const char *) const -> luabridge::LuaRef;
+
+    auto AddComponent(const char *) const -> luabridge::LuaRef;
+
+    auto RemoveComponent(luabridge::LuaRef) const -> void;
+};
+
+// Slot map owning every live actor. Released slots go on a free list and are reused by the next Create
+class ActorStore {
+  public:
+    static auto Create(Actor &&) -> Actor *;
+
+    // Call only once nothing outside Lua can reach the actor: its components are gone from every queue
+    static auto Release(Actor *) -> void;
+
+    static auto GetHandle(const Actor *) -> ActorHandle;
+
+    static auto Resolve(const ActorHandle &) -> Actor *;
+
+    // For box2d fixture user data, which only has room for the slot; null once the slot has been released.
+    // The slot may since have been reused, which Physics::GetFixtureActor checks for
+    static auto ResolveSlot(uint32_t) -> Actor *;
+
+    // Pushes the one userdata kept for a live actor, creating it on first use. Handles that no longer
+    // resolve get a fresh userdata each time, since their slot may already belong to another actor
+    static auto Push(lua_State *, const ActorHandle &) -> void;
+
+  private:
+    static inline std::deque<Actor> slots;
+    static inline std::vector<uint32_t> generations;
+    static inline std::vector<bool> live;
+    static inline std::vector<uint32_t> free_slots;
+    // Registry references to each slot's userdata, LUA_NOREF until the actor is first handed to Lua
+    static inline std::vector<int> lua_refs;
+};
+
+namespace luabridge {
+
+// Every way a handle reaches Lua (return values, LuaRefs, properties) goes through the cached userdata,
+// so lookups make no garbage and the same actor is the same Lua value. Without IsUserdata, references
+// and pointers to handles are pushed by value through here as well
+template <>
+struct Stack<ActorHandle> {
+    static auto push(lua_State *lua_state, const ActorHandle &handle) -> void {
+        ActorStore::Push(lua_state, handle);
+    }
+
+    static auto get(lua_State *lua_state, int index) -> ActorHandle {
+        return *detail::Userdata::get<ActorHandle>(lua_state, index, true);
+    }
+
+    static auto isInstance(lua_State *lua_state, int index) -> bool {
+        return detail::Userdata::isInstance<ActorHandle>(lua_state, index);
+    }
+};
+
+} // namespace luabridge
@@ -4,42 +4,56 @@
 #include <iostream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "rapidjson/document.h"
 #include "SDL_mixer.h"
 
 class AudioDB {
 public:
-    static inline auto LoadAudio(const std::string &audio_name) -> Mix_Chunk * {
-        if (const auto audio_it = loaded_audios.find(audio_name); audio_it != loaded_audios.end()) {
-            return audio_it->second;
+    // Lua API: loads the clip now and returns a handle for PlayAudioById
+    static inline auto LoadAudioHandle(const char *audio_name) -> int {
+        if (audio_name == nullptr) {
+            return -1;
+        }
+        const auto name = std::string(audio_name);
+        if (const auto handle_it = audio_handles.find(name); handle_it != audio_handles.end()) {
+            return handle_it->second;
         }
         Mix_Chunk *audio;
-        auto audio_file_wav = "core/audio/" + audio_name + ".wav";
-        auto audio_file_ogg = "core/audio/" + audio_name + ".ogg";
+        auto audio_file_wav = "core/audio/" + name + ".wav";
+        auto audio_file_ogg = "core/audio/" + name + ".ogg";
         if (std::filesystem::exists(audio_file_wav)) {
             audio = Mix_LoadWAV(audio_file_wav.c_str());
         } else if (std::filesystem::exists(audio_file_ogg)) {
             audio = Mix_LoadWAV(audio_file_ogg.c_str());
         } else {
-            audio_file_wav = "resources/audio/" + audio_name + ".wav";
-            audio_file_ogg = "resources/audio/" + audio_name + ".ogg";
+            audio_file_wav = "resources/audio/" + name + ".wav";
+            audio_file_ogg = "resources/audio/" + name + ".ogg";
             if (std::filesystem::exists(audio_file_wav)) {
                 audio = Mix_LoadWAV(audio_file_wav.c_str());
             } else if (std::filesystem::exists(audio_file_ogg)) {
                 audio = Mix_LoadWAV(audio_file_ogg.c_str());
             } else {
-                std::cout << "error: failed to play audio clip " << audio_name;
+                std::cout << "error: failed to play audio clip " << name;
                 exit(0);
             }
         }
-        loaded_audios.insert({ audio_name, audio });
-        return audio;
+        const auto handle = static_cast<int>(loaded_audios.size());
+        loaded_audios.push_back(audio);
+        audio_handles.insert({ name, handle });
+        return handle;
+    }
+
+    static inline auto PlayAudio(int channel, const char *audio_name, bool does_loop) -> void {
+        PlayAudioById(channel, LoadAudioHandle(audio_name), does_loop);
     }
 
-    static inline auto PlayAudio(int channel, const char *audio_name, bool does_loop) {
-        const auto audio = LoadAudio(audio_name);
-        Mix_PlayChannel(channel, audio, does_loop ? -1 : 0);
+    static inline auto PlayAudioById(int channel, int audio, bool does_loop) -> void {
+        if (audio < 0 || audio >= static_cast<int>(loaded_audios.size())) {
+            return;
+        }
+        Mix_PlayChannel(channel, loaded_audios[audio], does_loop ? -1 : 0);
     }
 
     static inline auto HaltAudio(int channel) {
@@ -51,5 +65,6 @@ public:
     }
 
 private:
-    static inline std::unordered_map<std::string, Mix_Chunk *> loaded_audios;
+    static inline std::unordered_map<std::string, int> audio_handles;
+    static inline std::vector<Mix_Chunk *> loaded_audios;
 };
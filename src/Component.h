@@ -3,16 +3,81 @@
 #include <string>
 #include <memory>
 
+#include "glm/glm.hpp"
 #include "rapidjson/document.h"
 
 #include "LuaDB.h"
 
+class Actor;
+
+using NativeCallback = void (*)(void *);
+// Returns a native instance to its type's pool and gives back a detached instance for stale Lua references
+using NativeRecycle = void *(*)(void *);
+// Writes a renderer's world-space bounds, returning false when it can't be drawn from the render grid
+using NativeBounds = auto (*)(void *, glm::vec2 &, glm::vec2 &) -> bool;
+
+// Registry references to a component's lifecycle functions, resolved once so calls skip the table lookup
+class ComponentFunctions {
+  public:
+    int on_start = LUA_NOREF;
+    int on_update = LUA_NOREF;
+    int on_late_update = LUA_NOREF;
+    int on_destroy = LUA_NOREF;
+
+    explicit ComponentFunctions(const luabridge::LuaRef &instance) {
+        on_start = Resolve(instance, "OnStart");
+        on_update = Resolve(instance, "OnUpdate");
+        on_late_update = Resolve(instance, "OnLateUpdate");
+        on_destroy = Resolve(instance, "OnDestroy");
+    }
+
+    ~ComponentFunctions() {
+        const auto lua_state = LuaDB::GetLuaState();
+        luaL_unref(lua_state, LUA_REGISTRYINDEX, on_start);
+        luaL_unref(lua_state, LUA_REGISTRYINDEX, on_update);
+        luaL_unref(lua_state, LUA_REGISTRYINDEX, on_late_update);
+        luaL_unref(lua_state, LUA_REGISTRYINDEX, on_destroy);
+    }
+
+    ComponentFunctions(const ComponentFunctions &) = delete;
+    auto operator=(const ComponentFunctions &) -> ComponentFunctions & = delete;
+
+  private:
+    static inline auto Resolve(const luabridge::LuaRef &instance, const char *name) -> int {
+        const auto function = instance[name];
+        if (function.isNil()) {
+            return LUA_NOREF;
+        }
+        const auto lua_state = LuaDB::GetLuaState();
+        function.push(lua_state);
+        return luaL_ref(lua_state, LUA_REGISTRYINDEX);
+    }
+};
+
 class Component {
   public:
     std::shared_ptr<luabridge::LuaRef> ref;
     std::string type;
     std::string key;
     size_t actor_id;
+    // Position in Scene::start_queue while OnStart is pending, so unregistering never has to search
+    size_t start_slot = 0;
+    // Set by RemoveComponent. The component stays in its actor's map but is never registered again
+    bool removed = false;
+
+    // Set for native components: the C++ instance behind ref and, if any, its update hook
+    void *native = nullptr;
+    NativeCallback native_update = nullptr;
+    // The native instance's own enabled field, read directly instead of through Lua
+    bool *native_enabled = nullptr;
+    // The native instance's actor field, pointed at its actor on injection and cleared when the actor is released
+    Actor **native_actor = nullptr;
+    // Called when the actor is released, so spawn and destroy churn reuses native storage
+    NativeRecycle native_recycle = nullptr;
+    // Set for renderers, which the scene draws from its render grid while their actor has no Rigidbody
+    NativeBounds native_bounds = nullptr;
+
+    std::shared_ptr<ComponentFunctions> functions;
 
     bool hasStart = false;
     bool hasUpdate = false;
@@ -24,11 +89,42 @@ class Component {
     bool hasOnTriggerExit = false;
 
     inline auto IsEnabled() -> bool {
-        return (*ref)["enabled"];
+        if (native_enabled != nullptr) {
+            return *native_enabled;
+        }
+        // Lua instances hold enabled as a raw field, read raw so a nil never falls through to the type table
+        const auto lua_state = LuaDB::GetLuaState();
+        ref->push(lua_state);
+        lua_pushliteral(lua_state, "enabled");
+        lua_rawget(lua_state, -2);
+        const auto enabled = lua_toboolean(lua_state, -1) != 0;
+        lua_pop(lua_state, 2);
+        return enabled;
     }
 
     inline auto SetEnabled(bool enabled) -> void {
-        (*ref)["enabled"] = enabled;
+        if (native_enabled != nullptr) {
+            *native_enabled = enabled;
+            return;
+        }
+        const auto lua_state = LuaDB::GetLuaState();
+        ref->push(lua_state);
+        lua_pushliteral(lua_state, "enabled");
+        lua_pushboolean(lua_state, enabled);
+        lua_rawset(lua_state, -3);
+        lua_pop(lua_state, 1);
+    }
+
+    // Calls one of the cached lifecycle functions with the instance as self, throwing LuaException on error like a LuaRef call
+    inline auto Call(int function) -> void {
+        const auto lua_state = LuaDB::GetLuaState();
+        lua_rawgeti(lua_state, LUA_REGISTRYINDEX, function);
+        ref->push(lua_state);
+        if (lua_pcall(lua_state, 1, 0, 0) != LUA_OK) {
+            auto e = luabridge::LuaException(lua_state, 0);
+            lua_pop(lua_state, 1);
+            throw e;
+        }
     }
 
     inline auto ApplyOverride(const std::string &property, const rapidjson::Value &val) {
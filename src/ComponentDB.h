@@ -5,7 +5,11 @@
 
 #include "Component.h"
 #include "LuaDB.h"
+#include "ParticleSystem.h"
 #include "Rigidbody.h"
+#include "SpriteRenderer.h"
+#include "TilemapCollider.h"
+#include "TileRenderer.h"
 
 class ComponentDB {
   public:
@@ -37,19 +41,22 @@ class ComponentDB {
         }
         auto new_component = Component{};
         new_component.ref = std::make_shared<luabridge::LuaRef>(luabridge::newTable(LuaDB::GetLuaState()));
-        LuaDB::EstablishInheritance(*new_component.ref, *component.ref);
+        // Flatten rather than inherit from the original, so clones of clones never build up __index chains
+        LuaDB::CopyFields(*new_component.ref, *component.ref);
+        LuaDB::EstablishInheritance(*new_component.ref, component.type);
         return MakeComponent(new_component, key, component.type);
     }
 
   private:
     static inline std::unordered_set<std::string> loaded_components;
-    static inline std::unordered_set<std::string> native_components = {"Rigidbody"};
+    static inline std::unordered_set<std::string> native_components = {"Rigidbody", "TileRenderer", "SpriteRenderer", "TilemapCollider", "ParticleSystem"};
 
     static inline auto MakeComponent(Component &component, const std::string &key, const std::string &component_name) -> Component {
         component.type = component_name;
         component.key = key;
         (*component.ref)["key"] = key;
         (*component.ref)["enabled"] = true;
+        component.functions = std::make_shared<ComponentFunctions>(*component.ref);
         component.hasStart = !(*component.ref)["OnStart"].isNil();
         component.hasUpdate = !(*component.ref)["OnUpdate"].isNil();
         component.hasLateUpdate = !(*component.ref)["OnLateUpdate"].isNil();
@@ -63,10 +70,9 @@ class ComponentDB {
 
     static inline auto MakeComponentInstance(const std::string &key, const std::string &component_name) -> Component {
         const auto lua_state = LuaDB::GetLuaState();
-        const auto parent_table = luabridge::getGlobal(lua_state, component_name.c_str());
         auto component = Component{};
         component.ref = std::make_shared<luabridge::LuaRef>(luabridge::newTable(lua_state));
-        LuaDB::EstablishInheritance(*component.ref, parent_table);
+        LuaDB::EstablishInheritance(*component.ref, component_name);
         return MakeComponent(component, key, component_name);
     }
 
@@ -74,7 +80,45 @@ class ComponentDB {
         const auto lua_state = LuaDB::GetLuaState();
         auto component = Component{};
         if (component_name == "Rigidbody") {
-            component.ref = std::make_shared<luabridge::LuaRef>(luabridge::LuaRef(lua_state, Rigidbody::MakeRigidbody()));
+            const auto rb = Rigidbody::MakeRigidbody();
+            component.ref = std::make_shared<luabridge::LuaRef>(luabridge::LuaRef(lua_state, rb));
+            component.native = rb;
+            component.native_enabled = &rb->enabled;
+            component.native_actor = &rb->actor;
+            component.native_recycle = &Rigidbody::Recycle;
+        } else if (component_name == "TileRenderer") {
+            const auto tile_renderer = TileRenderer::MakeTileRenderer();
+            component.ref = std::make_shared<luabridge::LuaRef>(luabridge::LuaRef(lua_state, tile_renderer));
+            component.native = tile_renderer;
+            component.native_enabled = &tile_renderer->enabled;
+            component.native_actor = &tile_renderer->actor;
+            component.native_recycle = &TileRenderer::Recycle;
+            component.native_update = &TileRenderer::Update;
+            component.native_bounds = &TileRenderer::GetBounds;
+        } else if (component_name == "SpriteRenderer") {
+            const auto sprite_renderer = SpriteRenderer::MakeSpriteRenderer();
+            component.ref = std::make_shared<luabridge::LuaRef>(luabridge::LuaRef(lua_state, sprite_renderer));
+            component.native = sprite_renderer;
+            component.native_enabled = &sprite_renderer->enabled;
+            component.native_actor = &sprite_renderer->actor;
+            component.native_recycle = &SpriteRenderer::Recycle;
+            component.native_update = &SpriteRenderer::Update;
+            component.native_bounds = &SpriteRenderer::GetBounds;
+        } else if (component_name == "TilemapCollider") {
+            const auto tilemap_collider = TilemapCollider::MakeTilemapCollider();
+            component.ref = std::make_shared<luabridge::LuaRef>(luabridge::LuaRef(lua_state, tilemap_collider));
+            component.native = tilemap_collider;
+            component.native_enabled = &tilemap_collider->enabled;
+            component.native_actor = &tilemap_collider->actor;
+            component.native_recycle = &TilemapCollider::Recycle;
+        } else if (component_name == "ParticleSystem") {
+            const auto particle_system = ParticleSystem::MakeParticleSystem();
+            component.ref = std::make_shared<luabridge::LuaRef>(luabridge::LuaRef(lua_state, particle_system));
+            component.native = particle_system;
+            component.native_enabled = &particle_system->enabled;
+            component.native_actor = &particle_system->actor;
+            component.native_recycle = &ParticleSystem::Recycle;
+            component.native_update = &ParticleSystem::Update;
         }
         return MakeComponent(component, key, component_name);
     }
@@ -106,6 +150,48 @@ class ComponentDB {
             rb->trigger_height = original_rb->trigger_height;
             rb->trigger_radius = original_rb->trigger_radius;
             component.ref = std::make_shared<luabridge::LuaRef>(luabridge::LuaRef(lua_state, rb));
+            component.native = rb;
+            component.native_enabled = &rb->enabled;
+            component.native_actor = &rb->actor;
+            component.native_recycle = &Rigidbody::Recycle;
+        } else if (original_component.type == "TileRenderer") {
+            const auto tile_renderer = TileRenderer::MakeTileRenderer();
+            *tile_renderer = *static_cast<const TileRenderer *>(original_component.native);
+            component.ref = std::make_shared<luabridge::LuaRef>(luabridge::LuaRef(lua_state, tile_renderer));
+            component.native = tile_renderer;
+            component.native_enabled = &tile_renderer->enabled;
+            component.native_actor = &tile_renderer->actor;
+            component.native_recycle = &TileRenderer::Recycle;
+            component.native_update = &TileRenderer::Update;
+            component.native_bounds = &TileRenderer::GetBounds;
+        } else if (original_component.type == "SpriteRenderer") {
+            const auto sprite_renderer = SpriteRenderer::MakeSpriteRenderer();
+            *sprite_renderer = *static_cast<const SpriteRenderer *>(original_component.native);
+            component.ref = std::make_shared<luabridge::LuaRef>(luabridge::LuaRef(lua_state, sprite_renderer));
+            component.native = sprite_renderer;
+            component.native_enabled = &sprite_renderer->enabled;
+            component.native_actor = &sprite_renderer->actor;
+            component.native_recycle = &SpriteRenderer::Recycle;
+            component.native_update = &SpriteRenderer::Update;
+            component.native_bounds = &SpriteRenderer::GetBounds;
+        } else if (original_component.type == "TilemapCollider") {
+            const auto tilemap_collider = TilemapCollider::MakeTilemapCollider();
+            *tilemap_collider = *static_cast<const TilemapCollider *>(original_component.native);
+            component.ref = std::make_shared<luabridge::LuaRef>(luabridge::LuaRef(lua_state, tilemap_collider));
+            component.native = tilemap_collider;
+            component.native_enabled = &tilemap_collider->enabled;
+            component.native_actor = &tilemap_collider->actor;
+            component.native_recycle = &TilemapCollider::Recycle;
+        } else if (original_component.type == "ParticleSystem") {
+            const auto particle_system = ParticleSystem::MakeParticleSystem();
+            *particle_system = *static_cast<const ParticleSystem *>(original_component.native);
+            particle_system->ResetSimulation();
+            component.ref = std::make_shared<luabridge::LuaRef>(luabridge::LuaRef(lua_state, particle_system));
+            component.native = particle_system;
+            component.native_enabled = &particle_system->enabled;
+            component.native_actor = &particle_system->actor;
+            component.native_recycle = &ParticleSystem::Recycle;
+            component.native_update = &ParticleSystem::Update;
         }
         return MakeComponent(component, key, original_component.type);
     }
@@ -14,6 +14,10 @@ class Config {
     std::string world_name;
     std::string initial_scene_name;
     std::string game_title;
+    std::string profiler_trace;
+    std::string stats_overlay_font;
+    std::string gc_mode = "incremental";
+    float gc_budget_ms = 1.0f;
     int window_width = 640;
     int window_height = 360;
     int clear_color_r = 255;
@@ -25,6 +29,7 @@ class Config {
     float default_tile_bounciness = 0.3f;
     glm::vec2 initial_camera_position;
     Uint32 min_milliseconds_between_frames = 16;
+    bool headless = false;
 
     inline auto ParseGameConfig(const rapidjson::Document &doc) -> void {
         world_name = DocUtils::GetString(doc, "world_name").value_or("");
@@ -32,6 +37,10 @@ class Config {
         game_title = DocUtils::GetString(doc, "game_title").value_or("");
         default_tile_friction = DocUtils::GetFloat(doc, "default_tile_friction").value_or(0.3f);
         default_tile_bounciness = DocUtils::GetFloat(doc, "default_tile_bounciness").value_or(0.3f);
+        profiler_trace = DocUtils::GetString(doc, "profiler_trace").value_or("");
+        stats_overlay_font = DocUtils::GetString(doc, "stats_overlay_font").value_or("");
+        gc_mode = DocUtils::GetString(doc, "gc_mode").value_or("incremental");
+        gc_budget_ms = DocUtils::GetFloat(doc, "gc_budget_ms").value_or(1.0f);
     }
 
     inline auto ParseRenderingConfig(const rapidjson::Document &doc) -> void {
@@ -50,5 +59,6 @@ class Config {
         } else {
             min_milliseconds_between_frames = 1;
         }
+        headless = DocUtils::GetBool(doc, "headless").value_or(false);
     }
 };
\ No newline at end of file
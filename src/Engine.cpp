@@ -20,12 +20,16 @@
 #include "EngineUtils.h"
 #include "Event.h"
 #include "Input.h"
+#include "LuaAllocator.h"
 #include "LuaDB.h"
+#include "LuaGC.h"
 #include "SceneDB.h"
 #include "TextDB.h"
 #include "Time.h"
 #include "TextureDB.h"
 #include "Physics.h"
+#include "Profiler.h"
+#include "Stats.h"
 
 /***************
  * Core game
@@ -35,6 +39,8 @@ auto Engine::GameLoop() -> void {
     GameInit();
 
     while (running) {
+        Profiler::BeginFrame(frame_number);
+
         EarlyUpdate();
 
         Input();
@@ -44,7 +50,10 @@ auto Engine::GameLoop() -> void {
         Render();
 
         LateUpdate();
+
+        Profiler::EndFrame();
     }
+    Profiler::Shutdown();
 }
 
 auto Engine::GameInit() -> void {
@@ -55,12 +64,7 @@ auto Engine::GameInit() -> void {
         std::cout << "error: resources/game.config missing";
         exit(0);
     }
-    SDL_Init(SDL_INIT_EVERYTHING);
-    IMG_Init(IMG_INIT_PNG);
-    TTF_Init();
     LuaDB::Init();
-    Mix_OpenAudio(48000, AUDIO_F32SYS, 2, 2048);
-    Mix_AllocateChannels(50);
     auto config_doc = rapidjson::Document();
     EngineUtils::ReadJsonFile("resources/game.config", config_doc);
     if (const auto it = config_doc.FindMember("initial_scene"); it == config_doc.MemberEnd() || !it->value.IsString()) {
@@ -68,41 +72,76 @@ auto Engine::GameInit() -> void {
         exit(0);
     }
     config.ParseGameConfig(config_doc);
+    LuaGC::Init(config.gc_mode, config.gc_budget_ms);
+    if (config.profiler_trace != "") {
+        Profiler::Init(config.profiler_trace);
+    }
+    if (config.stats_overlay_font != "") {
+        Stats::SetOverlayFont(config.stats_overlay_font);
+        Stats::SetEnabled(true);
+    }
     auto rendering_doc = rapidjson::Document();
     if (std::filesystem::exists("resources/rendering.config")) {
         EngineUtils::ReadJsonFile("resources/rendering.config", rendering_doc);
     }
     config.ParseRenderingConfig(rendering_doc);
-    window = SDL_CreateWindow(config.game_title.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, config.window_width, config.window_height, SDL_WINDOW_SHOWN);
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_ACCELERATED);
-    SDL_SetRenderDrawColor(renderer, config.clear_color_r, config.clear_color_g, config.clear_color_b, SDL_ALPHA_OPAQUE);
-    SDL_RenderClear(renderer);
+    if (config.headless) {
+        // No video subsystem: window and renderer stay null and all rendering becomes a no-op
+        SDL_Init(SDL_INIT_TIMER | SDL_INIT_AUDIO | SDL_INIT_EVENTS);
+    } else {
+        SDL_Init(SDL_INIT_EVERYTHING);
+    }
+    IMG_Init(IMG_INIT_PNG);
+    TTF_Init();
+    Mix_OpenAudio(48000, AUDIO_F32SYS, 2, 2048);
+    Mix_AllocateChannels(50);
+    if (!config.headless) {
+        window = SDL_CreateWindow(config.game_title.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, config.window_width, config.window_height, SDL_WINDOW_SHOWN);
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_ACCELERATED);
+        SDL_SetRenderDrawColor(renderer, config.clear_color_r, config.clear_color_g, config.clear_color_b, SDL_ALPHA_OPAQUE);
+        SDL_RenderClear(renderer);
+        TextureDB::BuildAtlas();
+    }
     camera_position = config.initial_camera_position;
     if (config.world_name != "") {
         SceneDB::LoadWorld(config.world_name);
     }
     scene = SceneDB::LoadScene(config.initial_scene_name);
-    scene.Reset();
+    scene.Reset({});
     Input::Init();
     Time::Init();
 }
 
 auto Engine::EarlyUpdate() -> void {
+    const auto scope = Profiler::Scope("EarlyUpdate");
     if (next_scene) {
-        auto persistent = std::vector<Actor>();
+        auto persistent = std::vector<Actor *>();
         for (const auto actor : scene.actors) {
+            if (actor == nullptr) {
+                continue;
+            }
             if (actor->persistent) {
-                persistent.push_back(std::move(*actor));
+                persistent.push_back(actor);
+            } else {
+                ActorStore::Release(actor);
             }
         }
+        const auto previous_layers = std::move(scene.tilemap_layers);
         scene = SceneDB::LoadScene(next_scene.value());
-        scene.actor_store.insert(scene.actor_store.begin(), persistent.begin(), persistent.end());
         next_scene = std::nullopt;
-        scene.Reset();
+        scene.Reset(persistent);
+        // SceneDB keeps every loaded scene's layers, so their chunk render targets are freed here rather
+        // than with the layer. Reloading the same scene keeps its chunks
+        for (const auto &layer : previous_layers) {
+            if (std::find(scene.tilemap_layers.begin(), scene.tilemap_layers.end(), layer) == scene.tilemap_layers.end()) {
+                layer->ReleaseChunks();
+            }
+        }
     }
 }
 
 auto Engine::Input() -> void {
+    const auto scope = Profiler::Scope("Input");
     auto event = SDL_Event();
     while (SDL_PollEvent(&event)) {
         switch (event.type) {
@@ -116,75 +155,168 @@ auto Engine::Input() -> void {
 }
 
 auto Engine::Update() -> void {
+    const auto scope = Profiler::Scope("Update");
     Time::Tick();
-    for (const auto &component : scene.start_queue) {
-        if (component->IsEnabled()) {
-            try {
-                (*component->ref)["OnStart"](*component->ref);
-            } catch (luabridge::LuaException const &e) {
-                LuaDB::ReportError(scene.id_to_actors[component->actor_id]->actor_name, e);
+    {
+        const auto start_scope = Profiler::Scope("OnStart");
+        for (const auto component : scene.start_queue) {
+            if (component != nullptr && component->IsEnabled()) {
+                try {
+                    component->Call(component->functions->on_start);
+                } catch (luabridge::LuaException const &e) {
+                    LuaDB::ReportError(scene.id_to_actors[component->actor_id]->actor_name, e);
+                }
             }
         }
+        scene.start_queue.clear();
     }
-    scene.start_queue.clear();
-    for (const auto &component : scene.update_queue) {
-        if (component->IsEnabled()) {
-            try {
-                (*component->ref)["OnUpdate"](*component->ref);
-            } catch (luabridge::LuaException const &e) {
-                LuaDB::ReportError(scene.id_to_actors[component->actor_id]->actor_name, e);
+    {
+        const auto update_scope = Profiler::Scope("OnUpdate");
+        scene.render_grid.CollectVisible();
+        for (auto i = size_t{0}; i < scene.update_queue.Size(); ++i) {
+            const auto component = scene.update_queue.At(i);
+            if (component != nullptr) {
+                scene.render_grid.DrawBefore(component);
+            }
+            if (component != nullptr && component->IsEnabled()) {
+                const auto stats_scope = Stats::Scope(*component);
+                if (component->native_update != nullptr) {
+                    component->native_update(component->native);
+                    continue;
+                }
+                try {
+                    component->Call(component->functions->on_update);
+                } catch (luabridge::LuaException const &e) {
+                    LuaDB::ReportError(scene.id_to_actors[component->actor_id]->actor_name, e);
+                }
             }
         }
+        scene.render_grid.DrawBefore(nullptr);
     }
-    for (const auto &component : scene.late_update_queue) {
-        if (component->IsEnabled()) {
-            try {
-                (*component->ref)["OnLateUpdate"](*component->ref);
-            } catch (luabridge::LuaException const &e) {
-                LuaDB::ReportError(scene.id_to_actors[component->actor_id]->actor_name, e);
+    {
+        const auto late_update_scope = Profiler::Scope("OnLateUpdate");
+        for (auto i = size_t{0}; i < scene.late_update_queue.Size(); ++i) {
+            const auto component = scene.late_update_queue.At(i);
+            if (component != nullptr && component->IsEnabled()) {
+                const auto stats_scope = Stats::Scope(*component);
+                try {
+                    component->Call(component->functions->on_late_update);
+                } catch (luabridge::LuaException const &e) {
+                    LuaDB::ReportError(scene.id_to_actors[component->actor_id]->actor_name, e);
+                }
             }
         }
     }
-    for (const auto &component : scene.destroy_queue) {
-        try {
-            (*component->ref)["OnDestroy"](*component->ref);
-        } catch (luabridge::LuaException const &e) {
-            LuaDB::ReportError(scene.id_to_actors[component->actor_id]->actor_name, e);
+    {
+        const auto destroy_scope = Profiler::Scope("OnDestroy");
+        scene.destroy_queue.Flush();
+        for (auto i = size_t{0}; i < scene.destroy_queue.Size(); ++i) {
+            if (const auto component = scene.destroy_queue.At(i); component != nullptr) {
+                CallOnDestroy(component);
+            }
         }
+        FinishDestroying();
+    }
+    {
+        const auto events_scope = Profiler::Scope("ResolveEvents");
+        Event::ResolveEvents();
+    }
+    {
+        const auto physics_scope = Profiler::Scope("PhysicsStep");
+        Physics::Step();
     }
-    Event::ResolveEvents();
-    Physics::Step();
 }
 
 auto Engine::Render() -> void {
-    SDL_SetRenderDrawColor(renderer, config.clear_color_r, config.clear_color_g, config.clear_color_b, SDL_ALPHA_OPAQUE);
-    SDL_RenderClear(renderer);
-    TextureDB::RenderTiles();
-    TextureDB::RenderScene();
-    TextureDB::RenderUI();
-    TextDB::RenderText();
-    TextureDB::RenderPixels();
+    const auto scope = Profiler::Scope("Render");
+    {
+        // Before clearing, since baking a new chunk switches render targets
+        const auto tilemaps_scope = Profiler::Scope("RenderTilemaps");
+        for (const auto &layer : scene.tilemap_layers) {
+            layer->Draw();
+        }
+    }
+    if (!config.headless) {
+        SDL_SetRenderDrawColor(renderer, config.clear_color_r, config.clear_color_g, config.clear_color_b, SDL_ALPHA_OPAQUE);
+        SDL_RenderClear(renderer);
+    }
+    {
+        const auto tiles_scope = Profiler::Scope("RenderTiles");
+        TextureDB::RenderTiles();
+    }
+    {
+        const auto scene_scope = Profiler::Scope("RenderScene");
+        TextureDB::RenderScene();
+    }
+    {
+        const auto ui_scope = Profiler::Scope("RenderUI");
+        TextureDB::RenderUI();
+    }
+    {
+        const auto text_scope = Profiler::Scope("RenderText");
+        Stats::DrawOverlay();
+        TextDB::RenderText();
+    }
+    {
+        const auto pixels_scope = Profiler::Scope("RenderPixels");
+        TextureDB::RenderPixels();
+    }
+    if (config.headless) {
+        // The render passes only drain their queues, so skip presenting and frame pacing
+        {
+            const auto gc_scope = Profiler::Scope("LuaGC");
+            LuaGC::Step(config.gc_budget_ms);
+        }
+        frame_number++;
+        return;
+    }
     static bool initialized = false;
     if (!initialized) {
         frame_number = 0;
         current_frame_start_timestamp = SDL_GetTicks();
         initialized = true;
     }
-    SDL_RenderPresent(renderer);
+    {
+        const auto present_scope = Profiler::Scope("RenderPresent");
+        SDL_RenderPresent(renderer);
+    }
+    {
+        // Collect in the time the frame would otherwise sleep through
+        const auto gc_scope = Profiler::Scope("LuaGC");
+        const auto elapsed_milliseconds = static_cast<int>(SDL_GetTicks() - current_frame_start_timestamp);
+        LuaGC::Step(static_cast<double>(static_cast<int>(config.min_milliseconds_between_frames) - elapsed_milliseconds));
+    }
     Uint32 current_frame_end_timestamp = SDL_GetTicks(); // Record end time of the frame
     Uint32 current_frame_duration_milliseconds = current_frame_end_timestamp - current_frame_start_timestamp;
     int delay_ticks = std::max(static_cast<int>(config.min_milliseconds_between_frames) - static_cast<int>(current_frame_duration_milliseconds), 1);
-    SDL_Delay(delay_ticks);
+    {
+        const auto delay_scope = Profiler::Scope("FrameDelay");
+        SDL_Delay(delay_ticks);
+    }
     current_frame_start_timestamp = SDL_GetTicks();
     frame_number++;
 }
 
 auto Engine::LateUpdate() -> void {
+    const auto scope = Profiler::Scope("LateUpdate");
     Input::LateUpdate();
+    {
+        // Collision callbacks run in the physics step, after the OnDestroy pass. Whatever they destroyed has
+        // to be torn down now, before unregistering drops it from the queue and its slot is released
+        const auto destroy_scope = Profiler::Scope("OnDestroy");
+        FinishDestroying();
+    }
+    // Removals first, while the start queue and the queues' pending insertions are empty, so unregistering never searches them
+    Actor::FinishRemovingComponents();
     FinishRemovingActors();
     FinishAddingActors();
-    Actor::FinishRemovingComponents();
     Actor::FinishAddingComponents();
+    scene.CompactActors();
+    scene.FlushQueues();
+    // Only after the flush, since the queues still order their tombstones by the removed components
+    ReleaseRemovedActors();
+    LuaAllocator::EndFrame();
+    Stats::EndFrame();
 }
 
 /***************
@@ -198,12 +330,36 @@ auto Engine::LateUpdate() -> void {
 /***************
  * Helpers
  ***************/
+auto Engine::CallOnDestroy(Component *component) -> void {
+    try {
+        component->Call(component->functions->on_destroy);
+    } catch (luabridge::LuaException const &e) {
+        LuaDB::ReportError(scene.id_to_actors[component->actor_id]->actor_name, e);
+    }
+}
+
+auto Engine::FinishDestroying() -> void {
+    // OnDestroy may destroy further actors; run theirs too without repeating anything already queued
+    while (scene.destroy_queue.HasPending()) {
+        for (const auto component : scene.destroy_queue.Flush()) {
+            CallOnDestroy(component);
+        }
+    }
+}
+
 auto Engine::FinishAddingActors() -> void {
     for (const auto actor : scene.add_actor_queue) {
-        scene.actors.insert(actor);
+        // Actors destroyed in the frame they were instantiated are dropped here rather than searched for
+        if (!actor->pending_add) {
+            continue;
+        }
+        actor->pending_add = false;
+        scene.AddActor(actor);
         for (auto &[key, component] : actor->components) {
             component.actor_id = actor->id;
-            scene.RegisterComponent(component);
+            if (!component.removed) {
+                scene.RegisterComponent(component);
+            }
         }
     }
     scene.add_actor_queue.clear();
@@ -214,10 +370,13 @@ auto Engine::FinishRemovingActors() -> void {
         for (auto &[key, component] : actor->components) {
             scene.UnregisterComponent(&component);
         }
-        const auto it = std::find(scene.actors.begin(), scene.actors.end(), actor);
-        if (it != scene.actors.end()) {
-            scene.actors.erase(it);
-        }
+        scene.RemoveActor(actor);
+    }
+}
+
+auto Engine::ReleaseRemovedActors() -> void {
+    for (const auto actor : scene.remove_actor_queue) {
+        ActorStore::Release(actor);
     }
     scene.remove_actor_queue.clear();
 }
@@ -227,8 +386,12 @@ auto Engine::FinishRemovingActors() -> void {
  ***************/
 auto Engine::FindActor(const char *name) -> luabridge::LuaRef {
     const auto lua_state = LuaDB::GetLuaState();
-    if (const auto it = scene.name_to_actors.find(name); it != scene.name_to_actors.end() && !it->second.empty()) {
-        return luabridge::LuaRef(lua_state, &it->second.front());
+    if (const auto it = scene.name_to_actors.find(name); it != scene.name_to_actors.end()) {
+        for (const auto actor : it->second.actors) {
+            if (actor != nullptr) {
+                return luabridge::LuaRef(lua_state, ActorStore::GetHandle(actor));
+            }
+        }
     }
     return luabridge::LuaRef(lua_state);
 }
@@ -238,9 +401,11 @@ auto Engine::FindAllActors(const char *name) -> luabridge::LuaRef {
     const auto found_components = luabridge::newTable(lua_state);
     if (const auto it = scene.name_to_actors.find(name); it != scene.name_to_actors.end()) {
         auto i = 1;
-        for (const auto actor : it->second) {
-            found_components[i] = luabridge::LuaRef(lua_state, actor);
-            ++i;
+        for (const auto actor : it->second.actors) {
+            if (actor != nullptr) {
+                found_components[i] = ActorStore::GetHandle(actor);
+                ++i;
+            }
         }
     }
     return found_components;
@@ -250,24 +415,26 @@ auto Engine::InstantiateActor(const char *template_name) -> luabridge::LuaRef {
     if (template_name == nullptr) {
         return luabridge::LuaRef(LuaDB::GetLuaState());
     }
-    auto actor = TemplateDB::LoadTemplate(template_name);
-    actor.id = Scene::actor_id_counter++;
-    scene.actor_store.push_back(actor);
-    scene.actor_store.back().BuildDataStructures();
-    scene.RegisterActor(scene.actor_store.back());
-    scene.add_actor_queue.push_back(&scene.actor_store.back());
-    return luabridge::LuaRef(LuaDB::GetLuaState(), &scene.actor_store.back());
+    const auto actor = ActorStore::Create(TemplateDB::LoadTemplate(template_name));
+    actor->id = Scene::actor_id_counter++;
+    actor->BuildDataStructures();
+    scene.RegisterActor(*actor);
+    actor->pending_add = true;
+    scene.add_actor_queue.push_back(actor);
+    return luabridge::LuaRef(LuaDB::GetLuaState(), ActorStore::GetHandle(actor));
 }
 
-auto Engine::DestroyActor(Actor *actor) -> void {
-    const auto it = std::find(scene.add_actor_queue.begin(), scene.add_actor_queue.end(), actor);
-    if (it != scene.add_actor_queue.end()) {
-        scene.add_actor_queue.erase(it);
+auto Engine::DestroyActor(ActorHandle handle) -> void {
+    // Stale handles and repeat calls are ignored, so an actor is queued for release only once
+    const auto actor = handle.Get();
+    if (actor == nullptr || scene.id_to_actors.find(actor->id) == scene.id_to_actors.end()) {
+        return;
     }
+    actor->pending_add = false;
     for (auto &[key, component] : actor->components) {
         component.SetEnabled(false);
         if (component.hasDestroy) {
-            scene.destroy_queue.insert(&component);
+            scene.destroy_queue.Insert(&component);
         }
     }
     scene.UnregisterActor(actor);
@@ -320,13 +487,24 @@ auto Engine::GetCameraZoom() -> float {
     return config.zoom_factor;
 }
 
+auto Engine::IsVisible(float x, float y, float w, float h) -> bool {
+    const auto half_view = GetViewHalfExtents();
+    return std::abs(x - camera_position.x) <= half_view.x + w * 0.5f && std::abs(y - camera_position.y) <= half_view.y + h * 0.5f;
+}
+
+auto Engine::GetViewHalfExtents() -> glm::vec2 {
+    return glm::vec2(config.window_width, config.window_height) * 0.5f / (config.zoom_factor * config.pixels_per_meter);
+}
+
 auto Engine::LoadScene(const char *scene_name) -> void {
     if (scene_name == nullptr) {
         return;
     }
     next_scene = scene_name;
-    for (const auto component : scene.has_destroy) {
-        scene.destroy_queue.insert(component);
+    for (auto i = size_t{0}; i < scene.has_destroy.Size(); ++i) {
+        if (const auto component = scene.has_destroy.At(i); component != nullptr) {
+            scene.destroy_queue.Insert(component);
+        }
     }
 }
 
@@ -334,6 +512,8 @@ auto Engine::GetCurrentScene() -> std::string {
     return scene.name;
 }
 
-auto Engine::DontDestroy(Actor *actor) -> void {
-    actor->persistent = true;
+auto Engine::DontDestroy(ActorHandle handle) -> void {
+    if (const auto actor = handle.Get(); actor != nullptr) {
+        actor->persistent = true;
+    }
 }
@@ -14,6 +14,7 @@
 #include "SDL.h"
 
 #include "Actor.h"
+#include "ActorStore.h"
 #include "Config.h"
 #include "Scene.h"
 
@@ -26,7 +27,7 @@ class Engine {
     static auto FindActor(const char *) -> luabridge::LuaRef;
     static auto FindAllActors(const char *) -> luabridge::LuaRef;
     static auto InstantiateActor(const char *) -> luabridge::LuaRef;
-    static auto DestroyActor(Actor *) -> void;
+    static auto DestroyActor(ActorHandle) -> void;
 
     // Application
     static auto GetFrame() -> int;
@@ -40,18 +41,22 @@ class Engine {
     static auto GetCameraPositionY() -> float;
     static auto SetCameraZoom(float) -> void;
     static auto GetCameraZoom() -> float;
+    static auto IsVisible(float, float, float, float) -> bool;
 
     // Scene
     static auto LoadScene(const char *) -> void;
     static auto GetCurrentScene() -> std::string;
-    static auto DontDestroy(Actor *) -> void;
+    static auto DontDestroy(ActorHandle) -> void;
 
     static inline Config config;
     static inline Scene scene;
 
-    static inline SDL_Renderer *renderer;
+    static inline SDL_Renderer *renderer = nullptr;
     static inline glm::vec2 camera_position;
 
+    // Half the size of the camera view in world units
+    static auto GetViewHalfExtents() -> glm::vec2;
+
   private:
     // Core game
     static auto GameInit() -> void;
@@ -68,11 +73,14 @@ class Engine {
     // Renderers
 
     // Helpers
+    static auto CallOnDestroy(Component *) -> void;
+    static auto FinishDestroying() -> void;
     static auto FinishAddingActors() -> void;
     static auto FinishRemovingActors() -> void;
+    static auto ReleaseRemovedActors() -> void;
 
     static inline bool running = true;
-    static inline SDL_Window *window;
+    static inline SDL_Window *window = nullptr;
     static inline std::optional<std::string> next_scene;
     static inline int frame_number = 0;
     static inline Uint32 current_frame_start_timestamp = 0;
@@ -0,0 +1,97 @@
+#include "LuaAllocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+auto LuaAllocator::Allocate(void *, void *ptr, size_t old_size, size_t new_size) -> void * {
+    // When ptr is null, old_size encodes the object type rather than a size
+    if (ptr == nullptr) {
+        old_size = 0;
+    }
+    if (new_size == 0) {
+        if (ptr != nullptr) {
+            Recycle(ptr, old_size);
+            live_bytes -= old_size;
+            live_blocks--;
+        }
+        return nullptr;
+    }
+    auto block = ptr;
+    if (ptr == nullptr) {
+        block = Acquire(new_size);
+    } else if (IsPooled(old_size) && IsPooled(new_size)) {
+        if (ClassOf(old_size) != ClassOf(new_size)) {
+            block = Acquire(new_size);
+            if (block != nullptr) {
+                std::memcpy(block, ptr, std::min(old_size, new_size));
+                Recycle(ptr, old_size);
+            }
+        }
+    } else if (!IsPooled(old_size) && !IsPooled(new_size)) {
+        block = std::realloc(ptr, new_size);
+    } else {
+        // Crossing between the pools and malloc
+        block = Acquire(new_size);
+        if (block != nullptr) {
+            std::memcpy(block, ptr, std::min(old_size, new_size));
+            Recycle(ptr, old_size);
+        }
+    }
+    if (block == nullptr) {
+        return nullptr;
+    }
+    if (ptr == nullptr) {
+        allocations++;
+        live_blocks++;
+    }
+    if (new_size > old_size) {
+        allocated_bytes += new_size - old_size;
+    }
+    live_bytes += new_size;
+    live_bytes -= old_size;
+    return block;
+}
+
+auto LuaAllocator::EndFrame() -> void {
+    frame_allocated_bytes = allocated_bytes - frame_start_allocated_bytes;
+    frame_allocations = allocations - frame_start_allocations;
+    frame_start_allocated_bytes = allocated_bytes;
+    frame_start_allocations = allocations;
+}
+
+auto LuaAllocator::Acquire(size_t size) -> void * {
+    if (!IsPooled(size)) {
+        return std::malloc(size);
+    }
+    const auto size_class = ClassOf(size);
+    if (const auto block = free_lists[size_class]; block != nullptr) {
+        free_lists[size_class] = block->next;
+        return block;
+    }
+    const auto block_size = (size_class + 1) * granularity;
+    if (chunk_end - chunk_cursor < static_cast<std::ptrdiff_t>(block_size)) {
+        // The old chunk's tail is too small for this class and is simply left unused
+        const auto chunk = static_cast<char *>(std::malloc(chunk_size));
+        if (chunk == nullptr) {
+            return nullptr;
+        }
+        chunks.push_back(chunk);
+        chunk_cursor = chunk;
+        chunk_end = chunk + chunk_size;
+    }
+    const auto block = chunk_cursor;
+    chunk_cursor += block_size;
+    return block;
+}
+
+auto LuaAllocator::Recycle(void *block, size_t size) -> void {
+    if (!IsPooled(size)) {
+        std::free(block);
+        return;
+    }
+    const auto free_block = static_cast<FreeBlock *>(block);
+    const auto size_class = ClassOf(size);
+    free_block->next = free_lists[size_class];
+    free_lists[size_class] = free_block;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// lua_Alloc for the engine's state. Blocks up to max_pooled_size come from per-size-class free lists
+// carved out of large chunks, so the small tables, strings and userdata scripts churn every frame
+// never reach malloc; larger blocks go straight to malloc. Not thread safe, like the state it serves
+class LuaAllocator {
+  public:
+    static auto Allocate(void *, void *, size_t, size_t) -> void *;
+
+    // Once per frame, to turn the running totals into a per-frame rate
+    static auto EndFrame() -> void;
+
+    // Running total of bytes requested, for measuring the allocation cost of a block of code
+    static inline auto GetAllocatedBytes() -> size_t {
+        return allocated_bytes;
+    }
+
+    static inline auto GetLiveBytes() -> size_t {
+        return live_bytes;
+    }
+
+    static inline auto GetLiveBlocks() -> size_t {
+        return live_blocks;
+    }
+
+    // Chunk memory held for the pools, whether in use or sitting on a free list
+    static inline auto GetPoolBytes() -> size_t {
+        return chunks.size() * chunk_size;
+    }
+
+    static inline auto GetFrameAllocatedBytes() -> size_t {
+        return frame_allocated_bytes;
+    }
+
+    static inline auto GetFrameAllocations() -> size_t {
+        return frame_allocations;
+    }
+
+  private:
+    class FreeBlock {
+      public:
+        FreeBlock *next;
+    };
+
+    static constexpr size_t granularity = 16;
+    static constexpr size_t class_count = 16;
+    static constexpr size_t max_pooled_size = granularity * class_count;
+    static constexpr size_t chunk_size = 64 * 1024;
+
+    static inline std::array<FreeBlock *, class_count> free_lists = {};
+    static inline std::vector<void *> chunks;
+    static inline char *chunk_cursor = nullptr;
+    static inline char *chunk_end = nullptr;
+
+    static inline size_t allocated_bytes = 0;
+    static inline size_t allocations = 0;
+    static inline size_t live_bytes = 0;
+    static inline size_t live_blocks = 0;
+    static inline size_t frame_start_allocated_bytes = 0;
+    static inline size_t frame_start_allocations = 0;
+    static inline size_t frame_allocated_bytes = 0;
+    static inline size_t frame_allocations = 0;
+
+    static inline auto IsPooled(size_t size) -> bool {
+        return size <= max_pooled_size;
+    }
+
+    static inline auto ClassOf(size_t size) -> size_t {
+        return (size + granularity - 1) / granularity - 1;
+    }
+
+    static auto Acquire(size_t) -> void *;
+
+    static auto Recycle(void *, size_t) -> void;
+};
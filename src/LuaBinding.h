@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+#include "LuaDB.h"
+
+// Generates plain lua_CFunctions for the engine calls hot enough that LuaBridge's generic dispatch shows up:
+// no upvalue holding the function pointer, arguments read straight off the stack, and self checked with a
+// single metatable comparison. Objects are still LuaBridge userdata, so both kinds of binding mix freely
+class LuaBinding {
+  public:
+    // For free and static functions, e.g. LuaBinding::Static<&Input::GetKey>
+    template <auto Function>
+    static auto Static(lua_State *lua_state) -> int {
+        return CallStatic(lua_state, Function);
+    }
+
+    // For member functions, called with self as the first argument. A member lua_CFunction receives the
+    // state as is, with its own arguments from index 2
+    template <auto Method>
+    static auto Member(lua_State *lua_state) -> int {
+        return CallMember(lua_state, Method);
+    }
+
+    // Installs raw methods into a class LuaBridge has already registered, next to its generated ones
+    template <typename T>
+    static auto AddMethods(lua_State *lua_state, std::initializer_list<std::pair<const char *, lua_CFunction>> methods) -> void {
+        lua_rawgetp(lua_state, LUA_REGISTRYINDEX, luabridge::detail::getClassRegistryKey<T>());
+        for (const auto &[name, method] : methods) {
+            lua_pushstring(lua_state, name);
+            lua_pushcfunction(lua_state, method);
+            lua_rawset(lua_state, -3);
+        }
+        lua_pop(lua_state, 1);
+    }
+
+    template <typename T>
+    static inline auto GetObject(lua_State *lua_state, int index) -> T * {
+        if (lua_getmetatable(lua_state, index)) {
+            lua_rawgetp(lua_state, LUA_REGISTRYINDEX, luabridge::detail::getClassRegistryKey<T>());
+            const auto exact = lua_rawequal(lua_state, -1, -2) != 0;
+            lua_pop(lua_state, 2);
+            if (exact) {
+                const auto userdata = static_cast<luabridge::detail::Userdata *>(lua_touserdata(lua_state, index));
+                return static_cast<T *>(userdata->*UserdataAccess::pointer);
+            }
+        }
+        // Const objects, subclasses and wrong types take LuaBridge's full check, which raises the usual error
+        return luabridge::detail::Userdata::get<T>(lua_state, index, true);
+    }
+
+    // Points an existing LuaBridge object userdata at another instance of the same class
+    static inline auto SetObject(lua_State *lua_state, int index, void *object) -> void {
+        const auto userdata = static_cast<luabridge::detail::Userdata *>(lua_touserdata(lua_state, index));
+        userdata->*UserdataAccess::pointer = object;
+    }
+
+  private:
+    class UserdataAccess : public luabridge::detail::Userdata {
+      public:
+        static constexpr auto pointer = &UserdataAccess::m_p;
+    };
+
+    template <typename T>
+    static inline auto Get(lua_State *lua_state, int index) -> T {
+        if constexpr (std::is_same_v<T, bool>) {
+            return lua_toboolean(lua_state, index) != 0;
+        } else if constexpr (std::is_integral_v<T>) {
+            return static_cast<T>(luaL_checkinteger(lua_state, index));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return static_cast<T>(luaL_checknumber(lua_state, index));
+        } else if constexpr (std::is_same_v<T, const char *>) {
+            return lua_isnil(lua_state, index) ? nullptr : luaL_checkstring(lua_state, index);
+        } else {
+            return *GetObject<std::remove_cv_t<std::remove_reference_t<T>>>(lua_state, index);
+        }
+    }
+
+    template <typename T>
+    static inline auto Push(lua_State *lua_state, const T &value) -> void {
+        if constexpr (std::is_same_v<T, bool>) {
+            lua_pushboolean(lua_state, value);
+        } else if constexpr (std::is_integral_v<T>) {
+            lua_pushinteger(lua_state, static_cast<lua_Integer>(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            lua_pushnumber(lua_state, static_cast<lua_Number>(value));
+        } else {
+            luabridge::Stack<T>::push(lua_state, value);
+        }
+    }
+
+    template <typename R, typename... Args, size_t... Indices>
+    static inline auto InvokeStatic(lua_State *lua_state, R (*function)(Args...), std::index_sequence<Indices...>) -> int {
+        if constexpr (std::is_void_v<R>) {
+            function(Get<Args>(lua_state, static_cast<int>(Indices) + 1)...);
+            return 0;
+        } else {
+            Push(lua_state, function(Get<Args>(lua_state, static_cast<int>(Indices) + 1)...));
+            return 1;
+        }
+    }
+
+    template <typename T, typename Method, typename R, typename... Args, size_t... Indices>
+    static inline auto InvokeMember(lua_State *lua_state, T *self, Method method, std::index_sequence<Indices...>) -> int {
+        if constexpr (std::is_void_v<R>) {
+            (self->*method)(Get<Args>(lua_state, static_cast<int>(Indices) + 2)...);
+            return 0;
+        } else {
+            Push(lua_state, (self->*method)(Get<Args>(lua_state, static_cast<int>(Indices) + 2)...));
+            return 1;
+        }
+    }
+
+    template <typename R, typename... Args>
+    static inline auto CallStatic(lua_State *lua_state, R (*function)(Args...)) -> int {
+        return InvokeStatic(lua_state, function, std::index_sequence_for<Args...>());
+    }
+
+    template <typename T, typename R, typename... Args>
+    static inline auto CallMember(lua_State *lua_state, R (T::*method)(Args...)) -> int {
+        return InvokeMember<T, decltype(method), R, Args...>(lua_state, GetObject<T>(lua_state, 1), method, std::index_sequence_for<Args...>());
+    }
+
+    template <typename T, typename R, typename... Args>
+    static inline auto CallMember(lua_State *lua_state, R (T::*method)(Args...) const) -> int {
+        return InvokeMember<T, decltype(method), R, Args...>(lua_state, GetObject<T>(lua_state, 1), method, std::index_sequence_for<Args...>());
+    }
+
+    template <typename T>
+    static inline auto CallMember(lua_State *lua_state, int (T::*method)(lua_State *)) -> int {
+        return (GetObject<T>(lua_state, 1)->*method)(lua_state);
+    }
+
+    template <typename T>
+    static inline auto CallMember(lua_State *lua_state, int (T::*method)(lua_State *) const) -> int {
+        return (GetObject<T>(lua_state, 1)->*method)(lua_state);
+    }
+};
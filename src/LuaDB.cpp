@@ -1,23 +1,39 @@
 #include "LuaDB.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 
 #include "box2d/box2d.h"
 
 #include "Actor.h"
+#include "ActorStore.h"
 #include "Engine.h"
 #include "Input.h"
+#include "LuaAllocator.h"
+#include "LuaBinding.h"
 #include "TextDB.h"
 #include "Time.h"
 #include "AudioDB.h"
 #include "TextureDB.h"
 #include "Rigidbody.h"
+#include "SpriteRenderer.h"
+#include "TilemapCollider.h"
+#include "TileRenderer.h"
+#include "ParticleSystem.h"
 #include "Physics.h"
 #include "Event.h"
+#include "Stats.h"
 
 auto LuaDB::Init() -> void {
-    lua_state = luaL_newstate();
+    // The allocator has to be in place from the start, since it can only free blocks it handed out
+    lua_state = lua_newstate(&LuaAllocator::Allocate, nullptr);
+    if (lua_state == nullptr) {
+        std::cout << "error: failed to create lua state";
+        exit(0);
+    }
+    lua_atpanic(lua_state, &Panic);
     luaL_openlibs(lua_state);
 
     // Vec2
@@ -35,6 +51,11 @@ auto LuaDB::Init() -> void {
         .addProperty("y", &b2Vec2::y)
         .addFunction("Normalize", &b2Vec2::Normalize)
         .addFunction("Length", &b2Vec2::Length)
+        // In place, unlike the operators, which each allocate a new Vector2
+        .addFunction("Set", &b2Vec2::Set)
+        .addFunction("Add", &b2Vec2::operator+=)
+        .addFunction("Sub", &b2Vec2::operator-=)
+        .addFunction("Scale", &b2Vec2::operator*=)
         .addFunction("__add", &b2Vec2::operator_add)
         .addFunction("__sub", &b2Vec2::operator_sub)
         .addFunction("__mul", &b2Vec2::operator_mul)
@@ -47,7 +68,7 @@ auto LuaDB::Init() -> void {
         .beginClass<Rigidbody>("Rigidbody")
         .addProperty("type", &Rigidbody::type)
         .addProperty("key", &Rigidbody::key)
-        .addProperty("actor", &Rigidbody::actor)
+        .addProperty("actor", &Rigidbody::GetActor)
         .addProperty("enabled", &Rigidbody::enabled)
         .addProperty("x", &Rigidbody::x)
         .addProperty("y", &Rigidbody::y)
@@ -69,27 +90,132 @@ auto LuaDB::Init() -> void {
         .addProperty("trigger_width", &Rigidbody::trigger_width)
         .addProperty("trigger_height", &Rigidbody::trigger_height)
         .addProperty("trigger_radius", &Rigidbody::trigger_radius)
-        .addFunction("GetPosition", &Rigidbody::GetPosition)
-        .addFunction("GetRotation", &Rigidbody::GetRotation)
-        .addFunction("GetVelocity", &Rigidbody::GetVelocity)
-        .addFunction("GetAngularVelocity", &Rigidbody::GetAngularVelocity)
-        .addFunction("GetGravityScale", &Rigidbody::GetGravityScale)
-        .addFunction("GetUpDirection", &Rigidbody::GetUpDirection)
-        .addFunction("GetRightDirection", &Rigidbody::GetRightDirection)
-        .addFunction("AddForce", &Rigidbody::AddForce)
-        .addFunction("AddTorque", &Rigidbody::AddTorque)
-        .addFunction("AddLinearImpulse", &Rigidbody::AddLinearImpulse)
-        .addFunction("AddAngularImpulse", &Rigidbody::AddAngularImpulse)
-        .addFunction("SetVelocity", &Rigidbody::SetVelocity)
-        .addFunction("SetPosition", &Rigidbody::SetPosition)
-        .addFunction("SetRotation", &Rigidbody::SetRotation)
-        .addFunction("SetAngularVelocity", &Rigidbody::SetAngularVelocity)
-        .addFunction("SetGravityScale", &Rigidbody::SetGravityScale)
-        .addFunction("SetUpDirection", &Rigidbody::SetUpDirection)
-        .addFunction("SetRightDirection", &Rigidbody::SetRightDirection)
         .addFunction("OnStart", &Rigidbody::OnStart)
         .addFunction("OnDestroy", &Rigidbody::OnDestroy)
         .endClass();
+    LuaBinding::AddMethods<Rigidbody>(lua_state, {
+        {"GetPosition", &LuaBinding::Member<&Rigidbody::GetPosition>},
+        {"GetRotation", &LuaBinding::Member<&Rigidbody::GetRotation>},
+        {"GetVelocity", &LuaBinding::Member<&Rigidbody::GetVelocity>},
+        {"GetAngularVelocity", &LuaBinding::Member<&Rigidbody::GetAngularVelocity>},
+        {"GetGravityScale", &LuaBinding::Member<&Rigidbody::GetGravityScale>},
+        {"GetUpDirection", &LuaBinding::Member<&Rigidbody::GetUpDirection>},
+        {"GetRightDirection", &LuaBinding::Member<&Rigidbody::GetRightDirection>},
+        {"AddForce", &LuaBinding::Member<&Rigidbody::AddForce>},
+        {"AddTorque", &LuaBinding::Member<&Rigidbody::AddTorque>},
+        {"AddLinearImpulse", &LuaBinding::Member<&Rigidbody::AddLinearImpulse>},
+        {"AddAngularImpulse", &LuaBinding::Member<&Rigidbody::AddAngularImpulse>},
+        {"SetVelocity", &LuaBinding::Member<&Rigidbody::SetVelocity>},
+        {"SetPosition", &LuaBinding::Member<&Rigidbody::SetPosition>},
+        {"SetRotation", &LuaBinding::Member<&Rigidbody::SetRotation>},
+        {"SetAngularVelocity", &LuaBinding::Member<&Rigidbody::SetAngularVelocity>},
+        {"SetGravityScale", &LuaBinding::Member<&Rigidbody::SetGravityScale>},
+        {"SetUpDirection", &LuaBinding::Member<&Rigidbody::SetUpDirection>},
+        {"SetRightDirection", &LuaBinding::Member<&Rigidbody::SetRightDirection>},
+        {"GetPositionXY", &LuaBinding::Member<&Rigidbody::GetPositionXY>},
+        {"GetVelocityXY", &LuaBinding::Member<&Rigidbody::GetVelocityXY>},
+        {"GetUpDirectionXY", &LuaBinding::Member<&Rigidbody::GetUpDirectionXY>},
+        {"GetRightDirectionXY", &LuaBinding::Member<&Rigidbody::GetRightDirectionXY>},
+        {"AddForceXY", &LuaBinding::Member<&Rigidbody::AddForceXY>},
+        {"AddLinearImpulseXY", &LuaBinding::Member<&Rigidbody::AddLinearImpulseXY>},
+        {"SetVelocityXY", &LuaBinding::Member<&Rigidbody::SetVelocityXY>},
+        {"SetPositionXY", &LuaBinding::Member<&Rigidbody::SetPositionXY>},
+    });
+    luabridge::getGlobalNamespace(lua_state)
+        .beginClass<TilemapCollider>("TilemapCollider")
+        .addProperty("type", &TilemapCollider::type)
+        .addProperty("key", &TilemapCollider::key)
+        .addProperty("actor", &TilemapCollider::GetActor)
+        .addProperty("enabled", &TilemapCollider::enabled)
+        .addProperty("friction", &TilemapCollider::friction)
+        .addProperty("bounciness", &TilemapCollider::bounciness)
+        .addFunction("OnStart", &TilemapCollider::OnStart)
+        .addFunction("OnDestroy", &TilemapCollider::OnDestroy)
+        .endClass();
+    luabridge::getGlobalNamespace(lua_state)
+        .beginClass<TileRenderer>("TileRenderer")
+        .addProperty("type", &TileRenderer::type)
+        .addProperty("key", &TileRenderer::key)
+        .addProperty("actor", &TileRenderer::GetActor)
+        .addProperty("enabled", &TileRenderer::enabled)
+        .addProperty("tileset", &TileRenderer::tileset)
+        .addProperty("x", &TileRenderer::GetX, &TileRenderer::SetX)
+        .addProperty("y", &TileRenderer::GetY, &TileRenderer::SetY)
+        .addProperty("w", &TileRenderer::GetW, &TileRenderer::SetW)
+        .addProperty("h", &TileRenderer::GetH, &TileRenderer::SetH)
+        .addProperty("tx", &TileRenderer::tx)
+        .addProperty("ty", &TileRenderer::ty)
+        .addProperty("tw", &TileRenderer::tw)
+        .addProperty("th", &TileRenderer::th)
+        .addProperty("tfx", &TileRenderer::tfx)
+        .addProperty("tfy", &TileRenderer::tfy)
+        .addProperty("r", &TileRenderer::r)
+        .addProperty("g", &TileRenderer::g)
+        .addProperty("b", &TileRenderer::b)
+        .addProperty("a", &TileRenderer::a)
+        .addProperty("sorting_order", &TileRenderer::sorting_order)
+        .addFunction("OnUpdate", &TileRenderer::OnUpdate)
+        .endClass();
+    luabridge::getGlobalNamespace(lua_state)
+        .beginClass<SpriteRenderer>("SpriteRenderer")
+        .addProperty("type", &SpriteRenderer::type)
+        .addProperty("key", &SpriteRenderer::key)
+        .addProperty("actor", &SpriteRenderer::GetActor)
+        .addProperty("enabled", &SpriteRenderer::enabled)
+        .addProperty("sprite", &SpriteRenderer::GetSprite, &SpriteRenderer::SetSprite)
+        .addProperty("x", &SpriteRenderer::GetX, &SpriteRenderer::SetX)
+        .addProperty("y", &SpriteRenderer::GetY, &SpriteRenderer::SetY)
+        .addProperty("w", &SpriteRenderer::w)
+        .addProperty("h", &SpriteRenderer::h)
+        .addProperty("r", &SpriteRenderer::r)
+        .addProperty("g", &SpriteRenderer::g)
+        .addProperty("b", &SpriteRenderer::b)
+        .addProperty("a", &SpriteRenderer::a)
+        .addProperty("sorting_order", &SpriteRenderer::sorting_order)
+        .addFunction("OnUpdate", &SpriteRenderer::OnUpdate)
+        .endClass()
+        .beginClass<ParticleSystem>("ParticleSystem")
+        .addProperty("type", &ParticleSystem::type)
+        .addProperty("key", &ParticleSystem::key)
+        .addProperty("actor", &ParticleSystem::GetActor)
+        .addProperty("enabled", &ParticleSystem::enabled)
+        .addProperty("image", &ParticleSystem::image)
+        .addProperty("x", &ParticleSystem::x)
+        .addProperty("y", &ParticleSystem::y)
+        .addProperty("sorting_order", &ParticleSystem::sorting_order)
+        .addProperty("frames_between_bursts", &ParticleSystem::frames_between_bursts)
+        .addProperty("burst_quantity", &ParticleSystem::burst_quantity)
+        .addProperty("duration_frames", &ParticleSystem::duration_frames)
+        .addProperty("emit_angle_min", &ParticleSystem::emit_angle_min)
+        .addProperty("emit_angle_max", &ParticleSystem::emit_angle_max)
+        .addProperty("emit_radius_min", &ParticleSystem::emit_radius_min)
+        .addProperty("emit_radius_max", &ParticleSystem::emit_radius_max)
+        .addProperty("start_speed_min", &ParticleSystem::start_speed_min)
+        .addProperty("start_speed_max", &ParticleSystem::start_speed_max)
+        .addProperty("rotation_min", &ParticleSystem::rotation_min)
+        .addProperty("rotation_max", &ParticleSystem::rotation_max)
+        .addProperty("rotation_speed_min", &ParticleSystem::rotation_speed_min)
+        .addProperty("rotation_speed_max", &ParticleSystem::rotation_speed_max)
+        .addProperty("gravity_scale_x", &ParticleSystem::gravity_scale_x)
+        .addProperty("gravity_scale_y", &ParticleSystem::gravity_scale_y)
+        .addProperty("drag_factor", &ParticleSystem::drag_factor)
+        .addProperty("angular_drag_factor", &ParticleSystem::angular_drag_factor)
+        .addProperty("start_scale_min", &ParticleSystem::start_scale_min)
+        .addProperty("start_scale_max", &ParticleSystem::start_scale_max)
+        .addProperty("end_scale", &ParticleSystem::end_scale)
+        .addProperty("start_color_r", &ParticleSystem::start_color_r)
+        .addProperty("start_color_g", &ParticleSystem::start_color_g)
+        .addProperty("start_color_b", &ParticleSystem::start_color_b)
+        .addProperty("start_color_a", &ParticleSystem::start_color_a)
+        .addProperty("end_color_r", &ParticleSystem::end_color_r)
+        .addProperty("end_color_g", &ParticleSystem::end_color_g)
+        .addProperty("end_color_b", &ParticleSystem::end_color_b)
+        .addProperty("end_color_a", &ParticleSystem::end_color_a)
+        .addFunction("OnUpdate", &ParticleSystem::OnUpdate)
+        .addFunction("Play", &ParticleSystem::Play)
+        .addFunction("Stop", &ParticleSystem::Stop)
+        .addFunction("Burst", &ParticleSystem::Burst)
+        .endClass();
     luabridge::getGlobalNamespace(lua_state)
         .beginClass<RigidbodyCollision>("Collision")
         .addProperty("other", &RigidbodyCollision::other)
@@ -110,19 +236,26 @@ auto LuaDB::Init() -> void {
         .beginNamespace("Debug")
         .addFunction("Log", &Log)
         .addFunction("LogError", &LogError)
+        .addFunction("GetStats", &Stats::GetStats)
+        .addFunction("EnableStats", &Stats::SetEnabled)
+        .addFunction("BenchmarkBindings", &BenchmarkBindings)
         .endNamespace();
 
     // Actor
     luabridge::getGlobalNamespace(lua_state)
-        .beginClass<Actor>("Actor")
-        .addFunction("GetName", &Actor::GetName)
-        .addFunction("GetID", &Actor::GetID)
-        .addFunction("GetComponentByKey", &Actor::GetComponentByKey)
-        .addFunction("GetComponent", &Actor::GetComponent)
-        .addFunction("GetComponents", &Actor::GetComponents)
-        .addFunction("AddComponent", &Actor::AddComponent)
-        .addFunction("RemoveComponent", &Actor::RemoveComponent)
+        .beginClass<ActorHandle>("Actor")
+        .addFunction("__eq", &ActorHandle::operator==)
+        .addFunction("IsValid", &ActorHandle::IsValid)
+        .addFunction("GetName", &ActorHandle::GetName)
+        .addFunction("GetID", &ActorHandle::GetID)
+        .addFunction("GetComponentByKey", &ActorHandle::GetComponentByKey)
+        .addFunction("GetComponents", &ActorHandle::GetComponents)
+        .addFunction("AddComponent", &ActorHandle::AddComponent)
+        .addFunction("RemoveComponent", &ActorHandle::RemoveComponent)
         .endClass();
+    LuaBinding::AddMethods<ActorHandle>(lua_state, {
+        {"GetComponent", &LuaBinding::Member<&ActorHandle::PushComponent>},
+    });
     luabridge::getGlobalNamespace(lua_state)
         .beginNamespace("Actor")
         .addFunction("Find", &Engine::FindActor)
@@ -143,26 +276,30 @@ auto LuaDB::Init() -> void {
     // Input
     luabridge::getGlobalNamespace(lua_state)
         .beginNamespace("Input")
-        .addFunction("GetKey", &Input::GetKey)
-        .addFunction("GetKeyDown", &Input::GetKeyDown)
-        .addFunction("GetKeyUp", &Input::GetKeyUp)
+        .addFunction("GetKey", &LuaBinding::Static<&Input::GetKey>)
+        .addFunction("GetKeyDown", &LuaBinding::Static<&Input::GetKeyDown>)
+        .addFunction("GetKeyUp", &LuaBinding::Static<&Input::GetKeyUp>)
         .addFunction("GetMousePosition", &Input::GetMousePosition)
-        .addFunction("GetMouseButton", &Input::GetMouseButton)
-        .addFunction("GetMouseButtonDown", &Input::GetMouseButtonDown)
-        .addFunction("GetMouseButtonUp", &Input::GetMouseButtonUp)
-        .addFunction("GetMouseScrollDelta", &Input::GetMouseScrollDelta)
+        .addFunction("GetMouseButton", &LuaBinding::Static<&Input::GetMouseButton>)
+        .addFunction("GetMouseButtonDown", &LuaBinding::Static<&Input::GetMouseButtonDown>)
+        .addFunction("GetMouseButtonUp", &LuaBinding::Static<&Input::GetMouseButtonUp>)
+        .addFunction("GetMouseScrollDelta", &LuaBinding::Static<&Input::GetMouseScrollDelta>)
         .endNamespace();
 
     // Text
     luabridge::getGlobalNamespace(lua_state)
         .beginNamespace("Text")
+        .addFunction("Load", &TextDB::LoadFontHandle)
         .addFunction("Draw", &TextDB::DrawText)
+        .addFunction("DrawById", &TextDB::DrawTextById)
         .endNamespace();
 
     // Audio
     luabridge::getGlobalNamespace(lua_state)
         .beginNamespace("Audio")
+        .addFunction("Load", &AudioDB::LoadAudioHandle)
         .addFunction("Play", &AudioDB::PlayAudio)
+        .addFunction("PlayById", &AudioDB::PlayAudioById)
         .addFunction("Halt", &AudioDB::HaltAudio)
         .addFunction("SetVolume", &AudioDB::SetVolume)
         .endNamespace();
@@ -170,13 +307,21 @@ auto LuaDB::Init() -> void {
     // Image
     luabridge::getGlobalNamespace(lua_state)
         .beginNamespace("Image")
-        .addFunction("DrawUI", &TextureDB::DrawUI)
-        .addFunction("DrawUIEx", &TextureDB::DrawUIEx)
-        .addFunction("Draw", &TextureDB::DrawImage)
-        .addFunction("DrawEx", &TextureDB::DrawImageEx)
-        .addFunction("DrawTile", &TextureDB::DrawTile)
-        .addFunction("DrawTileEx", &TextureDB::DrawTileEx)
-        .addFunction("DrawPixel", &TextureDB::DrawPixel)
+        .addFunction("Load", &TextureDB::LoadImageHandle)
+        .addFunction("DrawUI", &LuaBinding::Static<&TextureDB::DrawUI>)
+        .addFunction("DrawUIById", &LuaBinding::Static<&TextureDB::DrawUIById>)
+        .addFunction("DrawUIEx", &LuaBinding::Static<&TextureDB::DrawUIEx>)
+        .addFunction("DrawUIExById", &LuaBinding::Static<&TextureDB::DrawUIExById>)
+        .addFunction("Draw", &LuaBinding::Static<&TextureDB::DrawImage>)
+        .addFunction("DrawById", &LuaBinding::Static<&TextureDB::DrawImageById>)
+        .addFunction("DrawEx", &LuaBinding::Static<&TextureDB::DrawImageEx>)
+        .addFunction("DrawExById", &LuaBinding::Static<&TextureDB::DrawImageExById>)
+        .addFunction("DrawBatch", &TextureDB::DrawBatch)
+        .addFunction("DrawTile", &LuaBinding::Static<&TextureDB::DrawTile>)
+        .addFunction("DrawTileById", &LuaBinding::Static<&TextureDB::DrawTileById>)
+        .addFunction("DrawTileEx", &LuaBinding::Static<&TextureDB::DrawTileEx>)
+        .addFunction("DrawTileExById", &LuaBinding::Static<&TextureDB::DrawTileExById>)
+        .addFunction("DrawPixel", &LuaBinding::Static<&TextureDB::DrawPixel>)
         .endNamespace();
 
     // Image
@@ -187,6 +332,7 @@ auto LuaDB::Init() -> void {
         .addFunction("GetPositionY", &Engine::GetCameraPositionY)
         .addFunction("SetZoom", &Engine::SetCameraZoom)
         .addFunction("GetZoom", &Engine::GetCameraZoom)
+        .addFunction("IsVisible", &Engine::IsVisible)
         .endNamespace();
 
     // Scene
@@ -215,7 +361,7 @@ auto LuaDB::Init() -> void {
     // Time
     luabridge::getGlobalNamespace(lua_state)
         .beginNamespace("Time")
-        .addFunction("DeltaTime", &Time::DeltaTime)
+        .addFunction("DeltaTime", &LuaBinding::Static<&Time::DeltaTime>)
         .addFunction("UnscaledDeltaTime", &Time::UnscaledDeltaTime)
         .addFunction("GetTime", &Time::GetTime)
         .addFunction("GetUnscaledTime", &Time::GetUnscaledTime)
@@ -228,21 +374,45 @@ auto LuaDB::GetLuaState() -> lua_State * {
     return lua_state;
 }
 
-auto LuaDB::EstablishInheritance(luabridge::LuaRef &instance_table, const luabridge::LuaRef &parent_table) -> void {
-    luabridge::LuaRef new_metatable = luabridge::newTable(lua_state);
-    new_metatable["__index"] = parent_table;
+auto LuaDB::EstablishInheritance(luabridge::LuaRef &instance_table, const std::string &component_type) -> void {
+    auto metatable_it = component_metatables.find(component_type);
+    if (metatable_it == component_metatables.end()) {
+        auto metatable = luabridge::newTable(lua_state);
+        metatable["__index"] = luabridge::getGlobal(lua_state, component_type.c_str());
+        metatable_it = component_metatables.emplace(component_type, metatable).first;
+    }
     instance_table.push(lua_state);
-    new_metatable.push(lua_state);
+    metatable_it->second.push(lua_state);
     lua_setmetatable(lua_state, -2);
     lua_pop(lua_state, 1);
 }
 
+auto LuaDB::CopyFields(luabridge::LuaRef &destination_table, const luabridge::LuaRef &source_table) -> void {
+    destination_table.push(lua_state);
+    source_table.push(lua_state);
+    lua_pushnil(lua_state);
+    while (lua_next(lua_state, -2) != 0) {
+        // Stack: destination, source, key, value; keep a copy of key for the next lua_next
+        lua_pushvalue(lua_state, -2);
+        lua_insert(lua_state, -2);
+        lua_rawset(lua_state, -5);
+    }
+    lua_pop(lua_state, 2);
+}
+
 auto LuaDB::ReportError(const std::string &actor_name, const luabridge::LuaException &e) -> void {
     auto error_message = std::string(e.what());
     std::replace(error_message.begin(), error_message.end(), '\\', '/');
     std::cout << "\033[31m" << actor_name << " : " << error_message << "\033[0m" << std::endl;
 }
 
+// What luaL_newstate would have installed: errors outside any pcall end the game
+auto LuaDB::Panic(lua_State *state) -> int {
+    const auto message = lua_tostring(state, -1);
+    std::cout << "error: unprotected lua error " << (message != nullptr ? message : "") << std::endl;
+    exit(0);
+}
+
 auto LuaDB::Log(const char *message) -> void {
     std::cout << (message != nullptr ? message : "") << std::endl;
 }
@@ -250,3 +420,105 @@ auto LuaDB::Log(const char *message) -> void {
 auto LuaDB::LogError(const char *message) -> void {
     std::cerr << (message != nullptr ? message : "") << std::endl;
 }
+
+auto LuaDB::BenchmarkBindings(lua_State *state) -> int {
+    const auto iterations = luaL_optinteger(state, 1, 1000000);
+    const auto has_actor = !lua_isnoneornil(state, 2);
+    const auto type_name = has_actor ? luaL_checkstring(state, 3) : nullptr;
+    if (luaL_loadstring(state, "local f, n, a, b, c, d, e, g = ... for _ = 1, n do f(a, b, c, d, e, g) end") != LUA_OK) {
+        return lua_error(state);
+    }
+    const auto loop = lua_gettop(state);
+    lua_newtable(state);
+    const auto results = lua_gettop(state);
+    // Physics calls on a body-less rigidbody touch only its fields, so the timings are all dispatch
+    auto rigidbody = Rigidbody();
+
+    // The LuaBridge closures are built the way addFunction builds them
+    const auto push_static = [state](auto function) {
+        using Function = decltype(function);
+        lua_pushlightuserdata(state, reinterpret_cast<void *>(function));
+        lua_pushcclosure(state, &luabridge::detail::CFunc::Call<Function>::f, 1);
+    };
+    const auto push_member = [state](auto method) {
+        using Method = decltype(method);
+        new (lua_newuserdata(state, sizeof(Method))) Method(method);
+        if constexpr (luabridge::detail::FuncTraits<Method>::isConstMemberFunction) {
+            lua_pushcclosure(state, &luabridge::detail::CFunc::CallConstMember<Method>::f, 1);
+        } else {
+            lua_pushcclosure(state, &luabridge::detail::CFunc::CallMember<Method>::f, 1);
+        }
+    };
+    const auto time_loop = [state, loop, iterations](auto push_function, auto push_arguments) {
+        lua_pushvalue(state, loop);
+        push_function();
+        lua_pushinteger(state, iterations);
+        const auto arguments = push_arguments();
+        const auto start = std::chrono::steady_clock::now();
+        lua_call(state, 2 + arguments, 0);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    const auto compare = [state, results, &time_loop](const char *name, auto push_luabridge, auto push_raw, auto push_arguments) {
+        const auto luabridge_ms = time_loop(push_luabridge, push_arguments);
+        const auto raw_ms = time_loop(push_raw, push_arguments);
+        std::printf("%-24s luabridge %8.2f ms  raw %8.2f ms  %.2fx\n", name, luabridge_ms, raw_ms, luabridge_ms / raw_ms);
+        lua_createtable(state, 0, 2);
+        lua_pushnumber(state, luabridge_ms);
+        lua_setfield(state, -2, "luabridge_ms");
+        lua_pushnumber(state, raw_ms);
+        lua_setfield(state, -2, "raw_ms");
+        lua_setfield(state, results, name);
+    };
+
+    const auto no_arguments = [] { return 0; };
+    compare(
+        "Time.DeltaTime", [&] { push_static(&Time::DeltaTime); }, [&] { lua_pushcfunction(state, &LuaBinding::Static<&Time::DeltaTime>); }, no_arguments);
+    compare(
+        "Input.GetKey", [&] { push_static(&Input::GetKey); }, [&] { lua_pushcfunction(state, &LuaBinding::Static<&Input::GetKey>); },
+        [state] {
+            lua_pushstring(state, "space");
+            return 1;
+        });
+    compare(
+        "Image.DrawPixel", [&] { push_static(&TextureDB::DrawPixel); }, [&] { lua_pushcfunction(state, &LuaBinding::Static<&TextureDB::DrawPixel>); },
+        [state] {
+            for (const auto value : {-1.0, -1.0, 0.0, 0.0, 0.0, 0.0}) {
+                lua_pushnumber(state, value);
+            }
+            return 6;
+        });
+    const auto push_rigidbody = [state, &rigidbody] {
+        luabridge::push(state, &rigidbody);
+        return 1;
+    };
+    compare(
+        "Rigidbody:GetRotation", [&] { push_member(&Rigidbody::GetRotation); },
+        [&] { lua_pushcfunction(state, &LuaBinding::Member<&Rigidbody::GetRotation>); }, push_rigidbody);
+    compare(
+        "Rigidbody:SetRotation", [&] { push_member(&Rigidbody::SetRotation); },
+        [&] { lua_pushcfunction(state, &LuaBinding::Member<&Rigidbody::SetRotation>); },
+        [&] {
+            push_rigidbody();
+            lua_pushnumber(state, 0.0);
+            return 2;
+        });
+    compare(
+        "Rigidbody:GetPositionXY",
+        [&] {
+            using Method = decltype(&Rigidbody::GetPositionXY);
+            new (lua_newuserdata(state, sizeof(Method))) Method(&Rigidbody::GetPositionXY);
+            lua_pushcclosure(state, &luabridge::detail::CFunc::CallMemberCFunction<Rigidbody>::f, 1);
+        },
+        [&] { lua_pushcfunction(state, &LuaBinding::Member<&Rigidbody::GetPositionXY>); }, push_rigidbody);
+    if (has_actor) {
+        compare(
+            "Actor:GetComponent", [&] { push_member(&ActorHandle::GetComponent); },
+            [&] { lua_pushcfunction(state, &LuaBinding::Member<&ActorHandle::PushComponent>); },
+            [state, type_name] {
+                lua_pushvalue(state, 2);
+                lua_pushstring(state, type_name);
+                return 2;
+            });
+    }
+    return 1;
+}
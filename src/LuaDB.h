@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 
 #include "lua/lua.hpp"
 #include "LuaBridge/LuaBridge.h"
@@ -11,14 +12,24 @@ class LuaDB {
 
     static auto GetLuaState() -> lua_State *;
     
-    static auto EstablishInheritance(luabridge::LuaRef &, const luabridge::LuaRef &) -> void;
+    // Makes an instance inherit from the global table of its component type, through one metatable shared by the type
+    static auto EstablishInheritance(luabridge::LuaRef &, const std::string &) -> void;
+
+    // Copies the raw fields of the second table into the first, leaving metatables alone
+    static auto CopyFields(luabridge::LuaRef &, const luabridge::LuaRef &) -> void;
 
     static auto ReportError(const std::string &, const luabridge::LuaException &) -> void;
 
   private:
     static inline lua_State *lua_state;
+    static inline std::unordered_map<std::string, luabridge::LuaRef> component_metatables;
+
+    static auto Panic(lua_State *) -> int;
 
     static auto Log(const char *) -> void;
     
     static auto LogError(const char *) -> void;
+
+    // Times the hot bindings through LuaBridge's generic path and through LuaBinding, with the same Lua loop
+    static auto BenchmarkBindings(lua_State *) -> int;
 };
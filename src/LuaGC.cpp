@@ -0,0 +1,59 @@
+#include "LuaGC.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "LuaDB.h"
+
+auto LuaGC::Init(const std::string &mode, float gc_budget_ms) -> void {
+    const auto lua_state = LuaDB::GetLuaState();
+    if (mode == "generational") {
+        lua_gc(lua_state, LUA_GCGEN, 0, 0);
+        generational = true;
+    } else if (mode == "incremental") {
+        lua_gc(lua_state, LUA_GCINC, 0, 0, incremental_step_size_log2);
+        generational = false;
+    } else {
+        std::cout << "error: bad gc_mode " << mode;
+        exit(0);
+    }
+    budget_ms = gc_budget_ms;
+    enabled = budget_ms > 0.0;
+    if (enabled) {
+        lua_gc(lua_state, LUA_GCSTOP);
+        cycle_base_kb = std::max(lua_gc(lua_state, LUA_GCCOUNT), min_cycle_base_kb);
+    }
+}
+
+auto LuaGC::Step(double slack_ms) -> void {
+    if (!enabled) {
+        return;
+    }
+    const auto lua_state = LuaDB::GetLuaState();
+    const auto start = std::chrono::steady_clock::now();
+    const auto heap_kb = lua_gc(lua_state, LUA_GCCOUNT);
+    // At Lua's default pause of 200% the collector would already be running, so spend the budget
+    // regardless of slack; at twice that, finish the cycle whatever it costs rather than let the heap run away
+    const auto behind = heap_kb > cycle_base_kb * 2;
+    const auto far_behind = heap_kb > cycle_base_kb * 4;
+    const auto limit_ms = behind ? budget_ms : std::min(slack_ms, budget_ms);
+    auto elapsed_ms = 0.0;
+    last_steps = 0;
+    while (true) {
+        // A basic step is a slice of the incremental cycle. In generational mode it has to carry some debt,
+        // since only an indebted step may escalate from a young collection to a major one
+        const auto finished = lua_gc(lua_state, LUA_GCSTEP, generational ? generational_step_kb : 0) == 1;
+        last_steps++;
+        elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (finished || generational) {
+            cycle_base_kb = std::max(lua_gc(lua_state, LUA_GCCOUNT), min_cycle_base_kb);
+            collections++;
+            break;
+        }
+        if (!far_behind && elapsed_ms >= limit_ms) {
+            break;
+        }
+    }
+    last_step_ms = elapsed_ms;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+
+// Engine-driven Lua garbage collection. The collector's automatic steps are stopped and the work is done
+// between frames instead, in the time the frame would otherwise spend waiting for its deadline
+class LuaGC {
+  public:
+    // mode is "incremental" or "generational"; a budget of zero or less leaves Lua's own scheduling in place
+    static auto Init(const std::string &mode, float budget_ms) -> void;
+
+    // Runs collector steps for at most the budget, and no longer than the slack unless the heap is
+    // outgrowing the collector. Always does at least one step so collection keeps moving on busy frames
+    static auto Step(double slack_ms) -> void;
+
+    static inline auto IsGenerational() -> bool {
+        return generational;
+    }
+
+    static inline auto GetLastStepMs() -> double {
+        return last_step_ms;
+    }
+
+    static inline auto GetLastSteps() -> int {
+        return last_steps;
+    }
+
+    // Completed incremental cycles, or in generational mode collections of either kind, since Lua's
+    // API does not say whether a generational step was a young or a major collection
+    static inline auto GetCollections() -> int {
+        return collections;
+    }
+
+  private:
+    // Heaps smaller than this never count as outgrowing the collector
+    static constexpr int min_cycle_base_kb = 1024;
+    // Lua's default of 8 KB of work per step runs to several milliseconds on a large heap, too coarse for the budget
+    static constexpr int incremental_step_size_log2 = 10;
+    // Enough to outweigh the debt Lua keeps while its own collector is stopped
+    static constexpr int generational_step_kb = 4;
+
+    static inline bool enabled = false;
+    static inline bool generational = false;
+    static inline double budget_ms = 0.0;
+    // Heap size when the last cycle finished, which Lua's own pause is measured against
+    static inline int cycle_base_kb = min_cycle_base_kb;
+    static inline double last_step_ms = 0.0;
+    static inline int last_steps = 0;
+    static inline int collections = 0;
+};
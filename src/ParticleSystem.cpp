@@ -0,0 +1,198 @@
+#include "ParticleSystem.h"
+
+#include <cmath>
+#include <deque>
+#include <vector>
+#include <functional>
+
+#include "Engine.h"
+#include "EngineUtils.h"
+#include "TextureDB.h"
+
+auto ParticleSystem::OnUpdate() -> void {
+    if (emitting && frames_between_bursts > 0 && local_frame % frames_between_bursts == 0) {
+        Emit(burst_quantity);
+    }
+    Integrate();
+    RemoveExpired();
+    if (Engine::renderer != nullptr) {
+        Draw();
+    }
+    local_frame++;
+}
+
+auto ParticleSystem::Play() -> void {
+    emitting = true;
+}
+
+auto ParticleSystem::Stop() -> void {
+    emitting = false;
+}
+
+auto ParticleSystem::Burst() -> void {
+    Emit(burst_quantity);
+}
+
+auto ParticleSystem::Update(void *particle_system) -> void {
+    static_cast<ParticleSystem *>(particle_system)->OnUpdate();
+}
+
+auto ParticleSystem::ResetSimulation() -> void {
+    emitting = true;
+    local_frame = 0;
+    seeded = false;
+    pos_x.clear();
+    pos_y.clear();
+    vel_x.clear();
+    vel_y.clear();
+    rotation.clear();
+    angular_velocity.clear();
+    start_scale.clear();
+    age.clear();
+}
+
+auto ParticleSystem::Seed() -> void {
+    const auto actor_id = actor != nullptr ? static_cast<uint32_t>(actor->id) : 0u;
+    auto seed = std::seed_seq{298u, actor_id, static_cast<uint32_t>(std::hash<std::string>()(key))};
+    random_engine.seed(seed);
+    seeded = true;
+}
+
+auto ParticleSystem::Emit(int quantity) -> void {
+    if (quantity <= 0) {
+        return;
+    }
+    if (!seeded) {
+        Seed();
+    }
+    const auto new_size = pos_x.size() + static_cast<size_t>(quantity);
+    pos_x.reserve(new_size);
+    pos_y.reserve(new_size);
+    vel_x.reserve(new_size);
+    vel_y.reserve(new_size);
+    rotation.reserve(new_size);
+    angular_velocity.reserve(new_size);
+    start_scale.reserve(new_size);
+    age.reserve(new_size);
+    for (auto i = 0; i < quantity; ++i) {
+        const auto angle = EngineUtils::DegToRad(RandomRange(emit_angle_min, emit_angle_max));
+        const auto radius = RandomRange(emit_radius_min, emit_radius_max);
+        const auto speed = RandomRange(start_speed_min, start_speed_max);
+        const auto direction_x = std::cos(angle);
+        const auto direction_y = std::sin(angle);
+        pos_x.push_back(x + direction_x * radius);
+        pos_y.push_back(y + direction_y * radius);
+        vel_x.push_back(direction_x * speed);
+        vel_y.push_back(direction_y * speed);
+        rotation.push_back(RandomRange(rotation_min, rotation_max));
+        angular_velocity.push_back(RandomRange(rotation_speed_min, rotation_speed_max));
+        start_scale.push_back(RandomRange(start_scale_min, start_scale_max));
+        age.push_back(0);
+    }
+}
+
+auto ParticleSystem::Integrate() -> void {
+    const auto count = pos_x.size();
+    // Plain indexed loops over raw arrays, with no aliasing between them, so the compiler emits SIMD for each
+    auto *const px = pos_x.data();
+    auto *const py = pos_y.data();
+    auto *const vx = vel_x.data();
+    auto *const vy = vel_y.data();
+    auto *const rot = rotation.data();
+    auto *const ang = angular_velocity.data();
+    auto *const ages = age.data();
+    const auto gravity_x = gravity_scale_x;
+    const auto gravity_y = gravity_scale_y;
+    const auto drag = drag_factor;
+    const auto angular_drag = angular_drag_factor;
+    for (auto i = size_t{0}; i < count; ++i) {
+        vx[i] = (vx[i] + gravity_x) * drag;
+        vy[i] = (vy[i] + gravity_y) * drag;
+        px[i] += vx[i];
+        py[i] += vy[i];
+    }
+    for (auto i = size_t{0}; i < count; ++i) {
+        ang[i] *= angular_drag;
+        rot[i] += ang[i];
+    }
+    for (auto i = size_t{0}; i < count; ++i) {
+        ages[i]++;
+    }
+}
+
+auto ParticleSystem::RemoveExpired() -> void {
+    // Swap-remove keeps the arrays dense; draw order among particles of one system is not meaningful
+    auto count = age.size();
+    for (auto i = size_t{0}; i < count;) {
+        if (age[i] < duration_frames) {
+            ++i;
+            continue;
+        }
+        --count;
+        pos_x[i] = pos_x[count];
+        pos_y[i] = pos_y[count];
+        vel_x[i] = vel_x[count];
+        vel_y[i] = vel_y[count];
+        rotation[i] = rotation[count];
+        angular_velocity[i] = angular_velocity[count];
+        start_scale[i] = start_scale[count];
+        age[i] = age[count];
+    }
+    pos_x.resize(count);
+    pos_y.resize(count);
+    vel_x.resize(count);
+    vel_y.resize(count);
+    rotation.resize(count);
+    angular_velocity.resize(count);
+    start_scale.resize(count);
+    age.resize(count);
+}
+
+auto ParticleSystem::Draw() -> void {
+    if (image_handle < 0 || image != resolved_image) {
+        image_handle = TextureDB::GetTextureHandle(image);
+        resolved_image = image;
+    }
+    const auto lerp_or_keep = [](float start, float end, float t) { return end < 0.0f ? start : start + (end - start) * t; };
+    const auto inv_duration = duration_frames > 0 ? 1.0f / static_cast<float>(duration_frames) : 0.0f;
+    for (auto i = size_t{0}; i < pos_x.size(); ++i) {
+        const auto t = static_cast<float>(age[i]) * inv_duration;
+        const auto scale = lerp_or_keep(start_scale[i], end_scale, t);
+        TextureDB::DrawImageExById(image_handle, pos_x[i], pos_y[i], rotation[i], scale, scale, 0.5f, 0.5f,
+                                   lerp_or_keep(start_color_r, end_color_r, t), lerp_or_keep(start_color_g, end_color_g, t),
+                                   lerp_or_keep(start_color_b, end_color_b, t), lerp_or_keep(start_color_a, end_color_a, t), sorting_order);
+    }
+}
+
+auto ParticleSystem::RandomRange(float min, float max) -> float {
+    if (min >= max) {
+        return min;
+    }
+    return std::uniform_real_distribution<float>(min, max)(random_engine);
+}
+
+auto ParticleSystem::GetActor() const -> ActorHandle {
+    return ActorStore::GetHandle(actor);
+}
+
+static std::deque<ParticleSystem> ps_storage;
+static std::vector<ParticleSystem *> ps_free;
+// What stale Lua references to recycled instances point at from then on
+static ParticleSystem ps_detached;
+
+auto ParticleSystem::MakeParticleSystem() -> ParticleSystem * {
+    if (!ps_free.empty()) {
+        const auto instance = ps_free.back();
+        ps_free.pop_back();
+        return instance;
+    }
+    ps_storage.push_back(ParticleSystem{});
+    return &ps_storage.back();
+}
+
+auto ParticleSystem::Recycle(void *particle_system) -> void * {
+    const auto instance = static_cast<ParticleSystem *>(particle_system);
+    *instance = ParticleSystem{};
+    ps_free.push_back(instance);
+    return &ps_detached;
+}
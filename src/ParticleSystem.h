@@ -0,0 +1,101 @@
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ActorStore.h"
+
+// Emits bursts of short-lived images, simulated and drawn entirely in C++
+class ParticleSystem {
+  public:
+    std::string image = "???";
+    float x = 0.0f;
+    float y = 0.0f;
+    float sorting_order = 0.0f;
+
+    // Emission
+    int frames_between_bursts = 1;
+    int burst_quantity = 1;
+    int duration_frames = 300;
+    float emit_angle_min = 0.0f;
+    float emit_angle_max = 360.0f;
+    float emit_radius_min = 0.0f;
+    float emit_radius_max = 0.5f;
+
+    // Motion
+    float start_speed_min = 0.0f;
+    float start_speed_max = 0.0f;
+    float rotation_min = 0.0f;
+    float rotation_max = 0.0f;
+    float rotation_speed_min = 0.0f;
+    float rotation_speed_max = 0.0f;
+    float gravity_scale_x = 0.0f;
+    float gravity_scale_y = 0.0f;
+    float drag_factor = 1.0f;
+    float angular_drag_factor = 1.0f;
+
+    // Appearance over life; a negative end value keeps the start value
+    float start_scale_min = 1.0f;
+    float start_scale_max = 1.0f;
+    float end_scale = -1.0f;
+    float start_color_r = 255.0f;
+    float start_color_g = 255.0f;
+    float start_color_b = 255.0f;
+    float start_color_a = 255.0f;
+    float end_color_r = -1.0f;
+    float end_color_g = -1.0f;
+    float end_color_b = -1.0f;
+    float end_color_a = -1.0f;
+
+    std::string type = "ParticleSystem";
+    std::string key;
+    Actor *actor = nullptr;
+    bool enabled = true;
+
+    auto GetActor() const -> ActorHandle;
+
+    auto OnUpdate() -> void;
+
+    auto Play() -> void;
+    auto Stop() -> void;
+    auto Burst() -> void;
+
+    static auto Update(void *) -> void;
+
+    // Drops live particles, emission progress and the random stream, leaving only the settings. For clones
+    auto ResetSimulation() -> void;
+
+    static auto MakeParticleSystem() -> ParticleSystem *;
+
+    // Returns the instance to the pool once its actor is released, see Component::native_recycle
+    static auto Recycle(void *) -> void *;
+
+  private:
+    bool emitting = true;
+    int local_frame = 0;
+
+    std::string resolved_image;
+    int image_handle = -1;
+
+    // Seeded on first emission from the actor id and key, so emitters do not spawn in lockstep
+    bool seeded = false;
+    std::mt19937 random_engine;
+
+    // Live particles, kept dense in structure-of-arrays form so the integration loops vectorize
+    std::vector<float> pos_x;
+    std::vector<float> pos_y;
+    std::vector<float> vel_x;
+    std::vector<float> vel_y;
+    std::vector<float> rotation;
+    std::vector<float> angular_velocity;
+    std::vector<float> start_scale;
+    std::vector<int> age;
+
+    auto Seed() -> void;
+    auto Emit(int) -> void;
+    auto Integrate() -> void;
+    auto RemoveExpired() -> void;
+    auto Draw() -> void;
+    auto RandomRange(float, float) -> float;
+};
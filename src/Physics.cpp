@@ -1,6 +1,7 @@
 #include "Physics.h"
 
 #include "Rigidbody.h"
+#include "TilemapCollider.h"
 #include "Time.h"
 
 auto RaycastCallback::ReportFixture(b2Fixture *fixture, const b2Vec2 &point, const b2Vec2 &normal, float fraction) -> float {
@@ -9,7 +10,7 @@ auto RaycastCallback::ReportFixture(b2Fixture *fixture, const b2Vec2 &point, con
         return -1;
     }
     auto hit = RaycastHitResult{};
-    hit.actor = reinterpret_cast<Actor *>(fixture->GetUserData().pointer);
+    hit.actor = ActorStore::GetHandle(Physics::GetFixtureActor(fixture));
     hit.point = point;
     hit.normal = normal;
     hit.is_trigger = category == RB_TRIGGER;
@@ -33,6 +34,31 @@ auto Physics::Step() -> void {
     }
 }
 
+auto Physics::GetFixtureActor(b2Fixture *fixture) -> Actor * {
+    static const auto rigidbody_type = std::string("Rigidbody");
+    static const auto tilemap_collider_type = std::string("TilemapCollider");
+    const auto actor = ActorStore::ResolveSlot(static_cast<uint32_t>(fixture->GetUserData().pointer - 1));
+    if (actor == nullptr) {
+        return nullptr;
+    }
+    const auto body = fixture->GetBody();
+    if (const auto it = actor->type_to_components.find(rigidbody_type); it != actor->type_to_components.end()) {
+        for (const auto component : it->second) {
+            if (static_cast<Rigidbody *>(component->native)->GetBody() == body) {
+                return actor;
+            }
+        }
+    }
+    if (const auto it = actor->type_to_components.find(tilemap_collider_type); it != actor->type_to_components.end()) {
+        for (const auto component : it->second) {
+            if (static_cast<TilemapCollider *>(component->native)->GetBody() == body) {
+                return actor;
+            }
+        }
+    }
+    return nullptr;
+}
+
 auto Physics::GetWorld() -> b2World & {
     if (!world) {
         Init();
@@ -5,7 +5,7 @@
 
 #include "box2d/box2d.h"
 
-#include "Actor.h"
+#include "ActorStore.h"
 #include "LuaDB.h"
 
 class RaycastCallback : public b2RayCastCallback {
@@ -15,7 +15,7 @@ class RaycastCallback : public b2RayCastCallback {
 
 class RaycastHitResult {
   public:
-    Actor *actor;
+    ActorHandle actor;
     b2Vec2 point;
     b2Vec2 normal;
     bool is_trigger;
@@ -35,6 +35,10 @@ class Physics {
 
     static auto GetWorld() -> b2World &;
 
+    // The actor whose Rigidbody or TilemapCollider owns the fixture's body. Fixture user data only holds the
+    // store slot, so a body that outlived its actor must not be reported as whoever holds the slot now
+    static auto GetFixtureActor(b2Fixture *) -> Actor *;
+
     static auto Raycast(b2Vec2, b2Vec2, float) -> luabridge::LuaRef;
 
     static auto RaycastAll(b2Vec2, b2Vec2, float) -> luabridge::LuaRef;
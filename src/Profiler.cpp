@@ -0,0 +1,75 @@
+#include "Profiler.h"
+
+#include <cstdlib>
+#include <iostream>
+
+Profiler::Scope::Scope(const char *scope_name) : name(scope_name) {
+    if (enabled) {
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+Profiler::Scope::~Scope() {
+    if (enabled) {
+        Record(name, start, std::chrono::steady_clock::now());
+    }
+}
+
+auto Profiler::Init(const std::string &trace_path) -> void {
+#ifdef _WIN32
+    fopen_s(&trace_file, trace_path.c_str(), "wb");
+#else
+    trace_file = fopen(trace_path.c_str(), "wb");
+#endif
+    if (trace_file == nullptr) {
+        std::cout << "error: failed to open trace file " << trace_path << std::endl;
+        return;
+    }
+    // Chrome's JSON array format, one complete ("X") event per scope
+    std::fputs("[\n", trace_file);
+    epoch = std::chrono::steady_clock::now();
+    enabled = true;
+    std::atexit(Shutdown);
+}
+
+auto Profiler::BeginFrame(int frame_number) -> void {
+    if (!enabled) {
+        return;
+    }
+    frame = frame_number;
+    frame_start = std::chrono::steady_clock::now();
+}
+
+auto Profiler::EndFrame() -> void {
+    if (!enabled) {
+        return;
+    }
+    const auto frame_end = std::chrono::steady_clock::now();
+    const auto to_us = [](const auto duration) { return std::chrono::duration<double, std::micro>(duration).count(); };
+    std::fprintf(trace_file, "%s{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1,\"args\":{\"frame\":%d}}",
+                 first_event ? "" : ",\n", to_us(frame_start - epoch), to_us(frame_end - frame_start), frame);
+    first_event = false;
+    for (const auto &event : frame_events) {
+        std::fprintf(trace_file, ",\n{\"name\":\"%s\",\"cat\":\"engine\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+                     event.name, event.start_us, event.duration_us);
+    }
+    frame_events.clear();
+}
+
+auto Profiler::Shutdown() -> void {
+    if (!enabled) {
+        return;
+    }
+    enabled = false;
+    std::fputs("\n]\n", trace_file);
+    std::fclose(trace_file);
+    trace_file = nullptr;
+}
+
+auto Profiler::Record(const char *name, std::chrono::time_point<std::chrono::steady_clock> start, std::chrono::time_point<std::chrono::steady_clock> end) -> void {
+    frame_events.push_back({
+        name,
+        std::chrono::duration<double, std::micro>(start - epoch).count(),
+        std::chrono::duration<double, std::micro>(end - start).count(),
+    });
+}
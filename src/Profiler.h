@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class Profiler {
+  public:
+    // Records the lifetime of the enclosing block as one trace event
+    class Scope {
+      public:
+        explicit Scope(const char *);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        auto operator=(const Scope &) -> Scope & = delete;
+
+      private:
+        const char *name;
+        std::chrono::time_point<std::chrono::steady_clock> start;
+    };
+
+    static auto Init(const std::string &) -> void;
+
+    static auto BeginFrame(int) -> void;
+
+    static auto EndFrame() -> void;
+
+    static auto Shutdown() -> void;
+
+    static inline auto IsEnabled() -> bool {
+        return enabled;
+    }
+
+  private:
+    class TraceEvent {
+      public:
+        const char *name;
+        double start_us;
+        double duration_us;
+    };
+
+    static inline bool enabled = false;
+    static inline bool first_event = true;
+    static inline int frame = 0;
+    static inline FILE *trace_file = nullptr;
+    static inline std::chrono::time_point<std::chrono::steady_clock> epoch;
+    static inline std::chrono::time_point<std::chrono::steady_clock> frame_start;
+    static inline std::vector<TraceEvent> frame_events;
+
+    static auto Record(const char *, std::chrono::time_point<std::chrono::steady_clock>, std::chrono::time_point<std::chrono::steady_clock>) -> void;
+};
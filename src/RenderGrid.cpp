@@ -0,0 +1,142 @@
+#include "RenderGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Engine.h"
+#include "EngineUtils.h"
+#include "Stats.h"
+
+RenderGrid::RenderGrid(const RenderGrid &) {
+}
+
+auto RenderGrid::operator=(const RenderGrid &) -> RenderGrid & {
+    Clear();
+    return *this;
+}
+
+auto RenderGrid::Insert(Component *component) -> bool {
+    auto min = glm::vec2(0.0f);
+    auto max = glm::vec2(0.0f);
+    if (component->native_bounds == nullptr || !component->native_bounds(component->native, min, max)) {
+        return false;
+    }
+    const auto [it, inserted] = entries.try_emplace(component->native);
+    if (!inserted) {
+        Unlink(it->second);
+    }
+    it->second.component = component;
+    it->second.min = min;
+    it->second.max = max;
+    Link(it->second);
+    return true;
+}
+
+auto RenderGrid::Refresh(void *renderer) -> void {
+    const auto it = entries.find(renderer);
+    if (it == entries.end()) {
+        return;
+    }
+    Unlink(it->second);
+    it->second.component->native_bounds(renderer, it->second.min, it->second.max);
+    Link(it->second);
+}
+
+auto RenderGrid::Remove(void *renderer) -> void {
+    const auto it = entries.find(renderer);
+    if (it == entries.end()) {
+        return;
+    }
+    Unlink(it->second);
+    entries.erase(it);
+}
+
+auto RenderGrid::Clear() -> void {
+    entries.clear();
+    cells.clear();
+    visible.clear();
+    next_visible = 0;
+}
+
+auto RenderGrid::CollectVisible() -> void {
+    visible.clear();
+    next_visible = 0;
+    if (entries.empty()) {
+        return;
+    }
+    const auto half_view = Engine::GetViewHalfExtents();
+    const auto view_min = Engine::camera_position - half_view;
+    const auto view_max = Engine::camera_position + half_view;
+    const auto min_cell = GetCell(view_min);
+    const auto max_cell = GetCell(view_max);
+    // Entries spanning several cells are only collected once per query
+    ++query_stamp;
+    for (auto cell_x = min_cell.x; cell_x <= max_cell.x; ++cell_x) {
+        for (auto cell_y = min_cell.y; cell_y <= max_cell.y; ++cell_y) {
+            const auto it = cells.find(EngineUtils::PackIVec(glm::ivec2(cell_x, cell_y)));
+            if (it == cells.end()) {
+                continue;
+            }
+            for (const auto entry : it->second) {
+                if (entry->query_stamp == query_stamp) {
+                    continue;
+                }
+                entry->query_stamp = query_stamp;
+                if (entry->max.x < view_min.x || entry->min.x > view_max.x || entry->max.y < view_min.y || entry->min.y > view_max.y) {
+                    continue;
+                }
+                visible.push_back(entry);
+            }
+        }
+    }
+    std::sort(visible.begin(), visible.end(), [](const RenderGridEntry *a, const RenderGridEntry *b) {
+        return ComponentQueueCmp()(a->component, b->component);
+    });
+}
+
+auto RenderGrid::DrawBefore(const Component *component) -> void {
+    // Submission order breaks sorting_order ties, so grid draws are merged into the update queue's own order
+    for (; next_visible < visible.size(); ++next_visible) {
+        const auto entry_component = visible[next_visible]->component;
+        if (component != nullptr && !ComponentQueueCmp()(entry_component, component)) {
+            return;
+        }
+        if (entry_component->IsEnabled()) {
+            const auto stats_scope = Stats::Scope(*entry_component);
+            entry_component->native_update(entry_component->native);
+        }
+    }
+}
+
+auto RenderGrid::GetCell(glm::vec2 position) -> glm::ivec2 {
+    const auto cell_size = cell_size_px / Engine::config.pixels_per_meter;
+    return glm::ivec2(static_cast<int>(std::floor(position.x / cell_size)), static_cast<int>(std::floor(position.y / cell_size)));
+}
+
+auto RenderGrid::Link(RenderGridEntry &entry) -> void {
+    const auto min_cell = GetCell(entry.min);
+    const auto max_cell = GetCell(entry.max);
+    for (auto cell_x = min_cell.x; cell_x <= max_cell.x; ++cell_x) {
+        for (auto cell_y = min_cell.y; cell_y <= max_cell.y; ++cell_y) {
+            cells[EngineUtils::PackIVec(glm::ivec2(cell_x, cell_y))].push_back(&entry);
+        }
+    }
+}
+
+auto RenderGrid::Unlink(RenderGridEntry &entry) -> void {
+    const auto min_cell = GetCell(entry.min);
+    const auto max_cell = GetCell(entry.max);
+    for (auto cell_x = min_cell.x; cell_x <= max_cell.x; ++cell_x) {
+        for (auto cell_y = min_cell.y; cell_y <= max_cell.y; ++cell_y) {
+            const auto it = cells.find(EngineUtils::PackIVec(glm::ivec2(cell_x, cell_y)));
+            if (it == cells.end()) {
+                continue;
+            }
+            auto &cell = it->second;
+            cell.erase(std::remove(cell.begin(), cell.end(), &entry), cell.end());
+            if (cell.empty()) {
+                cells.erase(it);
+            }
+        }
+    }
+}
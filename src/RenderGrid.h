@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Component.h"
+
+class RenderGridEntry {
+  public:
+    Component *component = nullptr;
+    glm::vec2 min = glm::vec2(0.0f);
+    glm::vec2 max = glm::vec2(0.0f);
+    int query_stamp = 0;
+};
+
+// Buckets renderers that never move on their own so that each frame only those near the camera are visited.
+// Owned by the scene, which routes renderers in and out of it as Rigidbodies are added and removed
+class RenderGrid {
+  public:
+    RenderGrid() = default;
+    // Entries point at the live scene's components, so a copied scene starts with an empty grid
+    RenderGrid(const RenderGrid &);
+    auto operator=(const RenderGrid &) -> RenderGrid &;
+    RenderGrid(RenderGrid &&) = default;
+    auto operator=(RenderGrid &&) -> RenderGrid & = default;
+
+    // Returns false if the component's renderer can't be drawn from the grid
+    auto Insert(Component *) -> bool;
+    // Picks up a renderer's new bounds after a setter changed them, if it is in the grid
+    auto Refresh(void *) -> void;
+    auto Remove(void *) -> void;
+    auto Clear() -> void;
+
+    // Collects the entries overlapping the camera view, sorted in update queue order
+    auto CollectVisible() -> void;
+    // Draws the collected entries that come before a component in update queue order, or all remaining for null
+    auto DrawBefore(const Component *) -> void;
+
+  private:
+    static constexpr float cell_size_px = 256.0f;
+
+    std::unordered_map<void *, RenderGridEntry> entries;
+    std::unordered_map<uint64_t, std::vector<RenderGridEntry *>> cells;
+    std::vector<RenderGridEntry *> visible;
+    size_t next_visible = 0;
+    int query_stamp = 0;
+
+    static auto GetCell(glm::vec2) -> glm::ivec2;
+    auto Link(RenderGridEntry &) -> void;
+    auto Unlink(RenderGridEntry &) -> void;
+};
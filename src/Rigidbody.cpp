@@ -10,13 +10,16 @@
 
 auto RigidbodyContactListener::BeginContact(b2Contact *contact) -> void {
     const auto fixtureA = contact->GetFixtureA();
-    const auto actorA = reinterpret_cast<Actor *>(fixtureA->GetUserData().pointer);
+    const auto actorA = Physics::GetFixtureActor(fixtureA);
     const auto fixtureB = contact->GetFixtureB();
-    const auto actorB = reinterpret_cast<Actor *>(fixtureB->GetUserData().pointer);
+    const auto actorB = Physics::GetFixtureActor(fixtureB);
+    if (actorA == nullptr || actorB == nullptr) {
+        return;
+    }
     auto manifold = b2WorldManifold{};
     contact->GetWorldManifold(&manifold);
     auto collisionA = RigidbodyCollision{};
-    collisionA.other = actorB;
+    collisionA.other = ActorStore::GetHandle(actorB);
     collisionA.relative_velocity = fixtureA->GetBody()->GetLinearVelocity() - fixtureB->GetBody()->GetLinearVelocity();
     const auto categoryA = fixtureA->GetFilterData().categoryBits;
     if (categoryA == RB_COLLIDER) {
@@ -45,7 +48,7 @@ auto RigidbodyContactListener::BeginContact(b2Contact *contact) -> void {
         }
     }
     auto collisionB = RigidbodyCollision{};
-    collisionB.other = actorA;
+    collisionB.other = ActorStore::GetHandle(actorA);
     collisionB.relative_velocity = collisionA.relative_velocity;
     const auto categoryB = fixtureB->GetFilterData().categoryBits;
     if (categoryB == RB_COLLIDER) {
@@ -77,13 +80,16 @@ auto RigidbodyContactListener::BeginContact(b2Contact *contact) -> void {
 
 auto RigidbodyContactListener::EndContact(b2Contact *contact) -> void {
     const auto fixtureA = contact->GetFixtureA();
-    const auto actorA = reinterpret_cast<Actor *>(fixtureA->GetUserData().pointer);
+    const auto actorA = Physics::GetFixtureActor(fixtureA);
     const auto fixtureB = contact->GetFixtureB();
-    const auto actorB = reinterpret_cast<Actor *>(fixtureB->GetUserData().pointer);
+    const auto actorB = Physics::GetFixtureActor(fixtureB);
+    if (actorA == nullptr || actorB == nullptr) {
+        return;
+    }
     auto manifold = b2WorldManifold{};
     contact->GetWorldManifold(&manifold);
     auto collisionA = RigidbodyCollision{};
-    collisionA.other = actorB;
+    collisionA.other = ActorStore::GetHandle(actorB);
     collisionA.relative_velocity = fixtureA->GetBody()->GetLinearVelocity() - fixtureB->GetBody()->GetLinearVelocity();
     collisionA.point = {-999.0f, -999.0f};
     collisionA.normal = {-999.0f, -999.0f};
@@ -110,7 +116,7 @@ auto RigidbodyContactListener::EndContact(b2Contact *contact) -> void {
         }
     }
     auto collisionB = RigidbodyCollision{};
-    collisionB.other = actorA;
+    collisionB.other = ActorStore::GetHandle(actorA);
     collisionB.relative_velocity = collisionA.relative_velocity;
     collisionB.point = {-999.0f, -999.0f};
     collisionB.normal = {-999.0f, -999.0f};
@@ -260,6 +266,44 @@ auto Rigidbody::SetRightDirection(b2Vec2 direction) -> void {
     body->SetTransform(body->GetPosition(), angle);
 }
 
+static auto PushXY(lua_State *lua_state, const b2Vec2 &vector) -> int {
+    lua_pushnumber(lua_state, vector.x);
+    lua_pushnumber(lua_state, vector.y);
+    return 2;
+}
+
+auto Rigidbody::GetPositionXY(lua_State *lua_state) -> int {
+    return PushXY(lua_state, GetPosition());
+}
+
+auto Rigidbody::GetVelocityXY(lua_State *lua_state) -> int {
+    return PushXY(lua_state, GetVelocity());
+}
+
+auto Rigidbody::GetUpDirectionXY(lua_State *lua_state) -> int {
+    return PushXY(lua_state, GetUpDirection());
+}
+
+auto Rigidbody::GetRightDirectionXY(lua_State *lua_state) -> int {
+    return PushXY(lua_state, GetRightDirection());
+}
+
+auto Rigidbody::AddForceXY(float force_x, float force_y) -> void {
+    AddForce(b2Vec2(force_x, force_y));
+}
+
+auto Rigidbody::AddLinearImpulseXY(float impulse_x, float impulse_y) -> void {
+    AddLinearImpulse(b2Vec2(impulse_x, impulse_y));
+}
+
+auto Rigidbody::SetVelocityXY(float vel_x, float vel_y) -> void {
+    SetVelocity(b2Vec2(vel_x, vel_y));
+}
+
+auto Rigidbody::SetPositionXY(float pos_x, float pos_y) -> void {
+    SetPosition(b2Vec2(pos_x, pos_y));
+}
+
 auto Rigidbody::OnStart() -> void {
     auto def = b2BodyDef{};
     if (body_type == "dynamic") {
@@ -311,7 +355,8 @@ auto Rigidbody::OnStart() -> void {
             collider_fixture_def.restitution = bounciness;
             collider_fixture_def.filter.categoryBits = RB_COLLIDER;
             collider_fixture_def.filter.maskBits = RB_COLLIDER;
-            collider_fixture_def.userData.pointer = reinterpret_cast<uintptr_t>(actor);
+            // Store slot plus one, so fixtures without an actor keep the default of zero
+            collider_fixture_def.userData.pointer = static_cast<uintptr_t>(actor->store_slot) + 1;
             body->CreateFixture(&collider_fixture_def);
         }
         if (has_trigger) {
@@ -332,19 +377,59 @@ auto Rigidbody::OnStart() -> void {
             trigger_fixture_def.isSensor = true;
             trigger_fixture_def.filter.categoryBits = RB_TRIGGER;
             trigger_fixture_def.filter.maskBits = RB_TRIGGER;
-            trigger_fixture_def.userData.pointer = reinterpret_cast<uintptr_t>(actor);
+            trigger_fixture_def.userData.pointer = static_cast<uintptr_t>(actor->store_slot) + 1;
             body->CreateFixture(&trigger_fixture_def);
         }
     }
 }
 
 auto Rigidbody::OnDestroy() -> void {
-    Physics::GetWorld().DestroyBody(body);
+    if (body != nullptr) {
+        Physics::GetWorld().DestroyBody(body);
+        body = nullptr;
+    }
+}
+
+auto Rigidbody::GetActor() const -> ActorHandle {
+    return ActorStore::GetHandle(actor);
 }
 
 static std::deque<Rigidbody> rb_storage;
+static std::vector<Rigidbody *> rb_free;
+// What stale Lua references to recycled instances point at from then on
+static Rigidbody rb_detached;
 
 auto Rigidbody::MakeRigidbody() -> Rigidbody * {
+    if (!rb_free.empty()) {
+        const auto instance = rb_free.back();
+        rb_free.pop_back();
+        return instance;
+    }
     rb_storage.push_back(Rigidbody{});
     return &rb_storage.back();
 }
+
+auto Rigidbody::Recycle(void *rigidbody) -> void * {
+    const auto instance = static_cast<Rigidbody *>(rigidbody);
+    // OnDestroy clears the body, so one left here belongs to an instance whose OnDestroy never ran
+    if (instance->body != nullptr) {
+        Physics::GetWorld().DestroyBody(instance->body);
+    }
+    *instance = Rigidbody{};
+    rb_free.push_back(instance);
+    return &rb_detached;
+}
+
+auto Rigidbody::FindOnActor(Actor *actor) -> Rigidbody * {
+    static const auto rigidbody_type = std::string("Rigidbody");
+    if (actor == nullptr) {
+        return nullptr;
+    }
+    if (const auto it = actor->type_to_components.find(rigidbody_type); it != actor->type_to_components.end() && !it->second.empty()) {
+        const auto rb = static_cast<Rigidbody *>((*it->second.begin())->native);
+        if (rb != nullptr && rb->enabled) {
+            return rb;
+        }
+    }
+    return nullptr;
+}
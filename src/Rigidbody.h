@@ -5,7 +5,7 @@
 
 #include "box2d/box2d.h"
 
-#include "Actor.h"
+#include "ActorStore.h"
 
 class RigidbodyContactListener : public b2ContactListener {
   public:
@@ -21,7 +21,7 @@ enum RigidbodyFixtureCategory {
 
 class RigidbodyCollision {
   public:
-    Actor *other;
+    ActorHandle other;
     b2Vec2 point;
     b2Vec2 relative_velocity;
     b2Vec2 normal;
@@ -55,6 +55,8 @@ class Rigidbody {
     Actor *actor = nullptr;
     bool enabled = true;
 
+    auto GetActor() const -> ActorHandle;
+
     auto GetPosition() -> b2Vec2;
 
     auto GetRotation() -> float;
@@ -91,13 +93,40 @@ class Rigidbody {
 
     auto SetRightDirection(b2Vec2) -> void;
 
+    // Lua API variants that take and return plain numbers, so per-frame movement code allocates no Vector2 userdata
+    auto GetPositionXY(lua_State *) -> int;
+
+    auto GetVelocityXY(lua_State *) -> int;
+
+    auto GetUpDirectionXY(lua_State *) -> int;
+
+    auto GetRightDirectionXY(lua_State *) -> int;
+
+    auto AddForceXY(float, float) -> void;
+
+    auto AddLinearImpulseXY(float, float) -> void;
+
+    auto SetVelocityXY(float, float) -> void;
+
+    auto SetPositionXY(float, float) -> void;
+
     auto OnStart() -> void;
 
     auto OnDestroy() -> void;
 
+    inline auto GetBody() const -> const b2Body * {
+        return body;
+    }
+
     static auto MakeRigidbody() -> Rigidbody *;
 
+    // Returns the instance to the pool once its actor is released, see Component::native_recycle
+    static auto Recycle(void *) -> void *;
+
+    // Same lookup as actor:GetComponent("Rigidbody"), without going through Lua
+    static auto FindOnActor(Actor *) -> Rigidbody *;
+
   private:
-    b2Body *body;
+    b2Body *body = nullptr;
     RigidbodyContactListener contact_listener;
 };
\ No newline at end of file
@@ -9,12 +9,15 @@
 #include "glm/glm.hpp"
 
 #include "Actor.h"
+#include "ActorStore.h"
+#include "RenderGrid.h"
+#include "Tilemap.h"
 
-class ActorCmp {
+// Actors sharing a name in creation order; removals leave null tombstones until Scene::CompactActors
+class ActorBucket {
   public:
-    bool operator()(const Actor *a, const Actor *b) const {
-        return a->id < b->id;
-    }
+    std::vector<Actor *> actors;
+    size_t tombstones = 0;
 };
 
 class ComponentQueueCmp {
@@ -27,79 +30,268 @@ class ComponentQueueCmp {
     }
 };
 
+// Components sorted by (actor_id, key) in one contiguous array. Erase leaves a tombstone and Insert is
+// held back until Flush, so indices stay stable while the queue is being iterated
+class ComponentQueue {
+  public:
+    inline auto Insert(Component *component) -> void {
+        pending.push_back(component);
+    }
+
+    inline auto Erase(Component *component) -> void {
+        if (const auto it = std::find(pending.begin(), pending.end(), component); it != pending.end()) {
+            pending.erase(it);
+        }
+        if (const auto it = Find(component); it != entries.end() && !it->removed) {
+            it->removed = true;
+            tombstones++;
+        }
+    }
+
+    // Drops tombstones and merges pending insertions into place, returning the components that were not already queued
+    inline auto Flush() -> const std::vector<Component *> & {
+        if (tombstones > 0) {
+            entries.erase(std::remove_if(entries.begin(), entries.end(), [](const Entry &entry) { return entry.removed; }), entries.end());
+            tombstones = 0;
+        }
+        added.clear();
+        if (pending.empty()) {
+            return added;
+        }
+        std::sort(pending.begin(), pending.end(), ComponentQueueCmp());
+        pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+        for (const auto component : pending) {
+            if (Find(component) == entries.end()) {
+                added.push_back(component);
+            }
+        }
+        pending.clear();
+        const auto old_size = entries.size();
+        for (const auto component : added) {
+            entries.push_back({component, false});
+        }
+        std::inplace_merge(entries.begin(), entries.begin() + old_size, entries.end(), [](const Entry &a, const Entry &b) {
+            return ComponentQueueCmp()(a.component, b.component);
+        });
+        return added;
+    }
+
+    inline auto HasPending() const -> bool {
+        return !pending.empty();
+    }
+
+    inline auto Size() const -> size_t {
+        return entries.size();
+    }
+
+    // Null for entries erased since the last Flush
+    inline auto At(size_t index) const -> Component * {
+        return entries[index].removed ? nullptr : entries[index].component;
+    }
+
+  private:
+    class Entry {
+      public:
+        Component *component;
+        bool removed;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<Component *> pending;
+    std::vector<Component *> added;
+    size_t tombstones = 0;
+
+    inline auto Find(Component *component) -> std::vector<Entry>::iterator {
+        const auto it = std::lower_bound(entries.begin(), entries.end(), component, [](const Entry &entry, const Component *value) {
+            return ComponentQueueCmp()(entry.component, value);
+        });
+        return it != entries.end() && it->component == component ? it : entries.end();
+    }
+};
+
 class Scene {
   public:
     static inline auto actor_id_counter = size_t{0};
 
     std::string name;
+    // Prototypes from SceneDB; Reset moves them into ActorStore
     std::deque<Actor> actor_store;
-    std::set<Actor *, ActorCmp> actors;
+    // Ascending by id, with null tombstones for actors removed since the last CompactActors
+    std::vector<Actor *> actors;
+    size_t actor_tombstones = 0;
     std::unordered_map<size_t, Actor *> id_to_actors;
-    std::unordered_map<std::string, std::vector<Actor *>> name_to_actors;
+    std::unordered_map<std::string, ActorBucket> name_to_actors;
+    std::vector<ActorBucket *> dirty_name_buckets;
+    // Cleared after each OnStart pass, with null tombstones for components unregistered before it
     std::vector<Component *> start_queue;
-    std::set<Component *, ComponentQueueCmp> update_queue;
-    std::set<Component *, ComponentQueueCmp> late_update_queue;
-    std::set<Component *, ComponentQueueCmp> destroy_queue;
-    std::set<Component *, ComponentQueueCmp> has_destroy;
+    ComponentQueue update_queue;
+    ComponentQueue late_update_queue;
+    ComponentQueue destroy_queue;
+    ComponentQueue has_destroy;
     std::vector<Actor *> add_actor_queue;
     std::vector<Actor *> remove_actor_queue;
+    // Shared with SceneDB's copy of the scene, so reloading the same scene keeps its baked chunks
+    std::vector<std::shared_ptr<TilemapLayer>> tilemap_layers;
+    // Renderers on actors without a Rigidbody, drawn in update queue order in place of their queue entries
+    RenderGrid render_grid;
+    // Actors whose renderers are routed again at the next FlushQueues
+    std::vector<size_t> reroute_actors;
 
     inline auto RegisterComponent(Component &component) {
         if (component.hasStart && !id_to_actors[component.actor_id]->persistent) {
+            component.start_slot = start_queue.size();
             start_queue.push_back(&component);
         }
-        if (component.hasUpdate) {
-            update_queue.insert(&component);
+        if (component.native_bounds != nullptr || component.type == "Rigidbody") {
+            reroute_actors.push_back(component.actor_id);
+        }
+        if (component.hasUpdate && component.native_bounds == nullptr) {
+            update_queue.Insert(&component);
         }
         if (component.hasLateUpdate) {
-            late_update_queue.insert(&component);
+            late_update_queue.Insert(&component);
         }
         if (component.hasDestroy) {
-            has_destroy.insert(&component);
+            has_destroy.Insert(&component);
         }
     }
 
     inline auto UnregisterComponent(Component *component) {
-        if (component->hasStart) {
-            const auto it = std::find(start_queue.begin(), start_queue.end(), component);
-            if (it != start_queue.end()) {
-                start_queue.erase(it);
-            }
+        if (component->hasStart && component->start_slot < start_queue.size() && start_queue[component->start_slot] == component) {
+            start_queue[component->start_slot] = nullptr;
+        }
+        if (component->native_bounds != nullptr) {
+            render_grid.Remove(component->native);
+        }
+        if (component->type == "Rigidbody") {
+            reroute_actors.push_back(component->actor_id);
         }
         if (component->hasUpdate) {
-            update_queue.erase(component);
+            update_queue.Erase(component);
         }
         if (component->hasLateUpdate) {
-            late_update_queue.erase(component);
+            late_update_queue.Erase(component);
         }
         if (component->hasDestroy) {
-            destroy_queue.erase(component);
+            destroy_queue.Erase(component);
+            has_destroy.Erase(component);
         }
     }
 
     inline auto RegisterActor(Actor &actor) {
         id_to_actors[actor.id] = &actor;
-        name_to_actors[actor.actor_name].push_back(&actor);
+        auto &bucket = name_to_actors[actor.actor_name];
+        actor.name_slot = bucket.actors.size();
+        bucket.actors.push_back(&actor);
     }
 
     inline auto UnregisterActor(Actor *actor) {
         id_to_actors.erase(actor->id);
-        auto &name_to_actors_vec = name_to_actors[actor->actor_name];
-        name_to_actors_vec.erase(std::find(name_to_actors_vec.begin(), name_to_actors_vec.end(), actor));
+        auto &bucket = name_to_actors[actor->actor_name];
+        if (actor->name_slot < bucket.actors.size() && bucket.actors[actor->name_slot] == actor) {
+            bucket.actors[actor->name_slot] = nullptr;
+            if (bucket.tombstones++ == 0) {
+                dirty_name_buckets.push_back(&bucket);
+            }
+        }
+    }
+
+    inline auto AddActor(Actor *actor) {
+        actor->scene_slot = actors.size();
+        actors.push_back(actor);
     }
 
-    inline auto Reset() {
-        for (auto &actor : actor_store) {
-            actor.id = actor_id_counter++;
-            actor.BuildDataStructures();
-            actors.insert(&actor);
-            RegisterActor(actor);
+    inline auto RemoveActor(Actor *actor) {
+        if (actor->scene_slot < actors.size() && actors[actor->scene_slot] == actor) {
+            actors[actor->scene_slot] = nullptr;
+            actor_tombstones++;
         }
-        for (auto &actor : actors) {
+    }
+
+    // Once per frame, drops the tombstones left by RemoveActor and UnregisterActor while keeping creation order
+    inline auto CompactActors() -> void {
+        if (actor_tombstones > 0) {
+            auto next_slot = size_t{0};
+            for (const auto actor : actors) {
+                if (actor != nullptr) {
+                    actor->scene_slot = next_slot;
+                    actors[next_slot++] = actor;
+                }
+            }
+            actors.resize(next_slot);
+            actor_tombstones = 0;
+        }
+        for (const auto bucket : dirty_name_buckets) {
+            auto next_slot = size_t{0};
+            for (const auto actor : bucket->actors) {
+                if (actor != nullptr) {
+                    actor->name_slot = next_slot;
+                    bucket->actors[next_slot++] = actor;
+                }
+            }
+            bucket->actors.resize(next_slot);
+            bucket->tombstones = 0;
+        }
+        dirty_name_buckets.clear();
+    }
+
+    // Persistent actors carried over from the previous scene come first and keep their handles
+    inline auto Reset(const std::vector<Actor *> &persistent) {
+        for (const auto actor : persistent) {
+            AdoptActor(*actor);
+        }
+        for (auto &prototype : actor_store) {
+            AdoptActor(*ActorStore::Create(std::move(prototype)));
+        }
+        actor_store.clear();
+        for (const auto actor : actors) {
             for (auto &[key, component] : actor->components) {
                 component.actor_id = actor->id;
                 RegisterComponent(component);
             }
         }
+        FlushQueues();
+    }
+
+    inline auto AdoptActor(Actor &actor) -> void {
+        actor.id = actor_id_counter++;
+        actor.BuildDataStructures();
+        AddActor(&actor);
+        RegisterActor(actor);
+    }
+
+    // Once per frame, after the add and remove queues are processed
+    inline auto FlushQueues() -> void {
+        RouteRenderers();
+        update_queue.Flush();
+        late_update_queue.Flush();
+        destroy_queue.Flush();
+        has_destroy.Flush();
+    }
+
+    // Only scripts can move a renderer whose actor has no Rigidbody, so it goes in the render grid and is
+    // skipped while off-screen. Otherwise it is updated from the queue to follow the body
+    inline auto RouteRenderers() -> void {
+        for (const auto actor_id : reroute_actors) {
+            const auto it = id_to_actors.find(actor_id);
+            if (it == id_to_actors.end()) {
+                continue;
+            }
+            const auto actor = it->second;
+            const auto bodies = actor->type_to_components.find("Rigidbody");
+            const auto use_grid = bodies == actor->type_to_components.end() || bodies->second.empty();
+            for (auto &[key, component] : actor->components) {
+                if (component.native_bounds == nullptr || component.removed) {
+                    continue;
+                }
+                if (use_grid && render_grid.Insert(&component)) {
+                    update_queue.Erase(&component);
+                } else {
+                    render_grid.Remove(component.native);
+                    update_queue.Insert(&component);
+                }
+            }
+        }
+        reroute_actors.clear();
     }
 };
@@ -3,8 +3,10 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "rapidjson/document.h"
 #include "ldtk.hpp"
@@ -64,22 +66,25 @@ class SceneDB {
             const auto layers = level.get_layer_instances();
             if (layers) {
                 auto num_actors = size_t{0};
+                auto has_tiles = false;
                 for (const auto &layer : layers.value()) {
                     if (layer.get_type() == "Entities") {
                         num_actors += layer.get_entity_instances().size();
-                    } else if (layer.get_type() == "Tiles") {
-                        num_actors += layer.get_grid_tiles().size();
-                    } else if (layer.get_type() == "AutoLayer" || layer.get_type() == "IntGrid") {
-                        num_actors += layer.get_auto_layer_tiles().size();
+                    } else if (IsTileLayer(layer)) {
+                        if (!GetLayerTiles(layer).empty()) {
+                            has_tiles = true;
+                            if (!IsBackgroundLayer(layer.get_identifier())) {
+                                ++num_actors;
+                            }
+                        }
                     }
                 }
-                if (num_actors > 0) {
+                if (num_actors > 0 || has_tiles) {
                     auto scene = Scene{};
                     scene.name = scene_name;
                     scene.actor_store.resize(num_actors);
                     auto layer_number = 0;
                     auto i = 0U;
-                    const auto bg_prefix = std::string("_bg");
                     for (const auto &layer : layers.value()) {
                         const auto &identifier = layer.get_identifier();
                         const auto opacity = layer.get_opacity();
@@ -89,28 +94,24 @@ class SceneDB {
                                 actor.ParseLdtkEntity(layer_number, tilesets, opacity, entity);
                                 ++i;
                             }
-                        } else if (layer.get_type() == "Tiles") {
-                            const auto is_bg = identifier.size() >= 2 && identifier.compare(identifier.length() - bg_prefix.length(), bg_prefix.length(), bg_prefix) == 0;
-                            const auto tileset = tilesets[layer.get_tileset_def_uid().value()];
+                        } else if (IsTileLayer(layer) && !GetLayerTiles(layer).empty()) {
+                            // Tiles are drawn from the layer's grid, and solid layers get one actor holding their merged collider
+                            const auto is_bg = IsBackgroundLayer(identifier);
                             const auto grid_size = layer.get_grid_size();
-                            const auto start_idx = i;
-                            for (const auto &tile : layer.get_grid_tiles()) {
-                                auto &actor = scene.actor_store[i];
-                                const auto name = "__tile_" + identifier + "_" + std::to_string(start_idx - i);
-                                actor.ParseLdtkTile(layer_number, tileset, opacity, grid_size, is_bg, tile, name);
-                                ++i;
+                            auto tilemap = std::make_shared<TilemapLayer>(tilesets[layer.get_tileset_def_uid().value()], static_cast<int>(grid_size),
+                                                                          static_cast<int>(layer.get_c_wid()), static_cast<int>(layer.get_c_hei()),
+                                                                          static_cast<int>(opacity * 255), -layer_number);
+                            for (const auto &tile : GetLayerTiles(layer)) {
+                                const auto &px = tile.get_px();
+                                const auto &src = tile.get_src();
+                                tilemap->SetTile(static_cast<int>(px[0]), static_cast<int>(px[1]), static_cast<int>(src[0]), static_cast<int>(src[1]), static_cast<int>(tile.get_f()));
                             }
-                        } else if ((layer.get_type() == "AutoLayer" || layer.get_type() == "IntGrid") && layer.get_auto_layer_tiles().size() > 0) {
-                            const auto is_bg = identifier.size() >= 2 && identifier.compare(identifier.length() - bg_prefix.length(), bg_prefix.length(), bg_prefix) == 0;
-                            const auto tileset = tilesets[layer.get_tileset_def_uid().value()];
-                            const auto grid_size = layer.get_grid_size();
-                            const auto start_idx = i;
-                            for (const auto &tile : layer.get_auto_layer_tiles()) {
+                            if (!is_bg) {
                                 auto &actor = scene.actor_store[i];
-                                const auto name = "__tile_" + identifier + "_" + std::to_string(start_idx - i);
-                                actor.ParseLdtkTile(layer_number, tileset, opacity, grid_size, is_bg, tile, name);
+                                actor.ParseLdtkTilemapCollider(tilemap, "__tiles_" + identifier);
                                 ++i;
                             }
+                            scene.tilemap_layers.push_back(tilemap);
                         }
                         ++layer_number;
                     }
@@ -123,12 +124,27 @@ class SceneDB {
   private:
     static inline std::unordered_map<std::string, Scene> loaded_scenes;
 
+    static inline auto IsTileLayer(const ldtk::LayerInstance &layer) -> bool {
+        return layer.get_type() == "Tiles" || layer.get_type() == "AutoLayer" || layer.get_type() == "IntGrid";
+    }
+
+    static inline auto GetLayerTiles(const ldtk::LayerInstance &layer) -> const std::vector<ldtk::TileInstance> & {
+        return layer.get_type() == "Tiles" ? layer.get_grid_tiles() : layer.get_auto_layer_tiles();
+    }
+
+    // Layers whose identifier ends in "_bg" are decoration only and get no colliders
+    static inline auto IsBackgroundLayer(const std::string &identifier) -> bool {
+        const auto bg_suffix = std::string("_bg");
+        return identifier.size() >= bg_suffix.size() && identifier.compare(identifier.size() - bg_suffix.size(), bg_suffix.size(), bg_suffix) == 0;
+    }
+
     static inline auto CopyScene(const Scene &original) -> Scene {
         auto scene = Scene{};
         scene.name = original.name;
         for (const auto &actor : original.actor_store) {
             scene.actor_store.push_back(actor.Copy());
         }
+        scene.tilemap_layers = original.tilemap_layers;
         return scene; // return copy of actors
     }
 };
@@ -0,0 +1,117 @@
+#include "SpriteRenderer.h"
+
+#include <deque>
+#include <vector>
+#include <utility>
+
+#include "Engine.h"
+#include "Rigidbody.h"
+#include "TextureDB.h"
+
+auto SpriteRenderer::OnUpdate() -> void {
+    if (Engine::renderer == nullptr) {
+        return;
+    }
+    auto pos_x = x;
+    auto pos_y = y;
+    auto rot_degrees = 0.0f;
+    if (const auto rb = Rigidbody::FindOnActor(actor); rb != nullptr) {
+        const auto pos = rb->GetPosition();
+        pos_x = pos.x;
+        pos_y = pos.y;
+        rot_degrees = rb->GetRotation();
+    }
+    if (const auto cull_size = GetCullSize(rot_degrees); !Engine::IsVisible(pos_x, pos_y, cull_size.x, cull_size.y)) {
+        return;
+    }
+    TextureDB::DrawImageExById(sprite_handle, pos_x, pos_y, rot_degrees, 1.0f, 1.0f, 0.5f, 0.5f, r, g, b, a, sorting_order);
+}
+
+auto SpriteRenderer::GetSprite() const -> std::string {
+    return sprite;
+}
+
+auto SpriteRenderer::SetSprite(std::string new_sprite) -> void {
+    sprite = std::move(new_sprite);
+    MoveInGrid();
+}
+
+auto SpriteRenderer::GetX() const -> float {
+    return x;
+}
+
+auto SpriteRenderer::SetX(float new_x) -> void {
+    x = new_x;
+    MoveInGrid();
+}
+
+auto SpriteRenderer::GetY() const -> float {
+    return y;
+}
+
+auto SpriteRenderer::SetY(float new_y) -> void {
+    y = new_y;
+    MoveInGrid();
+}
+
+auto SpriteRenderer::GetBounds(void *sprite_renderer, glm::vec2 &min, glm::vec2 &max) -> bool {
+    if (Engine::renderer == nullptr) {
+        return false;
+    }
+    const auto renderer = static_cast<SpriteRenderer *>(sprite_renderer);
+    const auto half_size = renderer->GetCullSize(0.0f) * 0.5f;
+    min = glm::vec2(renderer->x, renderer->y) - half_size;
+    max = glm::vec2(renderer->x, renderer->y) + half_size;
+    return true;
+}
+
+auto SpriteRenderer::Update(void *sprite_renderer) -> void {
+    static_cast<SpriteRenderer *>(sprite_renderer)->OnUpdate();
+}
+
+auto SpriteRenderer::ResolveSprite() -> void {
+    if (sprite_handle < 0 || sprite != resolved_sprite) {
+        sprite_handle = TextureDB::GetTextureHandle(sprite);
+        resolved_sprite = sprite;
+    }
+}
+
+auto SpriteRenderer::GetCullSize(float rot_degrees) -> glm::vec2 {
+    ResolveSprite();
+    const auto texture = TextureDB::GetLoadedTexture(sprite_handle);
+    const auto size = glm::vec2(texture.w, texture.h) / static_cast<float>(Engine::config.pixels_per_meter);
+    if (rot_degrees != 0.0f) {
+        return glm::vec2(glm::length(size));
+    }
+    return size;
+}
+
+auto SpriteRenderer::MoveInGrid() -> void {
+    Engine::scene.render_grid.Refresh(this);
+}
+
+auto SpriteRenderer::GetActor() const -> ActorHandle {
+    return ActorStore::GetHandle(actor);
+}
+
+static std::deque<SpriteRenderer> sr_storage;
+static std::vector<SpriteRenderer *> sr_free;
+// What stale Lua references to recycled instances point at from then on
+static SpriteRenderer sr_detached;
+
+auto SpriteRenderer::MakeSpriteRenderer() -> SpriteRenderer * {
+    if (!sr_free.empty()) {
+        const auto instance = sr_free.back();
+        sr_free.pop_back();
+        return instance;
+    }
+    sr_storage.push_back(SpriteRenderer{});
+    return &sr_storage.back();
+}
+
+auto SpriteRenderer::Recycle(void *sprite_renderer) -> void * {
+    const auto instance = static_cast<SpriteRenderer *>(sprite_renderer);
+    *instance = SpriteRenderer{};
+    sr_free.push_back(instance);
+    return &sr_detached;
+}
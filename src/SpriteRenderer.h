@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+
+#include "glm/glm.hpp"
+
+#include "ActorStore.h"
+
+class SpriteRenderer {
+  public:
+    std::string sprite = "???";
+    float x = 0.0f;
+    float y = 0.0f;
+    float w = -1.0f;
+    float h = -1.0f;
+    float r = 255.0f;
+    float g = 255.0f;
+    float b = 255.0f;
+    float a = 255.0f;
+    float sorting_order = 0.0f;
+
+    std::string type = "SpriteRenderer";
+    std::string key;
+    Actor *actor = nullptr;
+    bool enabled = true;
+
+    auto GetActor() const -> ActorHandle;
+
+    auto OnUpdate() -> void;
+
+    // Position and sprite setters keep the render grid entry in sync
+    auto GetSprite() const -> std::string;
+    auto SetSprite(std::string) -> void;
+    auto GetX() const -> float;
+    auto SetX(float) -> void;
+    auto GetY() const -> float;
+    auto SetY(float) -> void;
+
+    static auto Update(void *) -> void;
+    // Bounds for the scene's render grid, see Component::native_bounds
+    static auto GetBounds(void *, glm::vec2 &, glm::vec2 &) -> bool;
+
+    static auto MakeSpriteRenderer() -> SpriteRenderer *;
+
+    // Returns the instance to the pool once its actor is released, see Component::native_recycle
+    static auto Recycle(void *) -> void *;
+
+  private:
+    auto ResolveSprite() -> void;
+    // World-space size used for culling, grown to the diagonal when rotated
+    auto GetCullSize(float) -> glm::vec2;
+    auto MoveInGrid() -> void;
+
+    // Texture handle for sprite, looked up again only when the name changes
+    std::string resolved_sprite;
+    int sprite_handle = -1;
+};
@@ -0,0 +1,143 @@
+#include "Stats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "Engine.h"
+#include "LuaAllocator.h"
+#include "LuaGC.h"
+#include "TextDB.h"
+
+Stats::Scope::Scope(const Component &scope_component) : component(scope_component), active(enabled) {
+    if (active) {
+        start_alloc_bytes = LuaAllocator::GetAllocatedBytes();
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+Stats::Scope::~Scope() {
+    if (!active) {
+        return;
+    }
+    const auto time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const auto alloc_bytes = LuaAllocator::GetAllocatedBytes() - start_alloc_bytes;
+    auto &type_sample = current_frame.types[component.type];
+    type_sample.calls++;
+    type_sample.time_ms += time_ms;
+    type_sample.alloc_bytes += alloc_bytes;
+    auto &actor_sample = current_frame.actors[component.actor_id];
+    if (actor_sample.calls == 0) {
+        if (const auto it = Engine::scene.id_to_actors.find(component.actor_id); it != Engine::scene.id_to_actors.end()) {
+            actor_sample.name = it->second->actor_name;
+        }
+    }
+    actor_sample.calls++;
+    actor_sample.time_ms += time_ms;
+    actor_sample.alloc_bytes += alloc_bytes;
+    current_frame.total_time_ms += time_ms;
+    current_frame.total_alloc_bytes += alloc_bytes;
+}
+
+auto Stats::SetEnabled(bool stats_enabled) -> void {
+    enabled = stats_enabled;
+}
+
+auto Stats::SetOverlayFont(const std::string &font_name) -> void {
+    overlay_font = font_name;
+}
+
+auto Stats::EndFrame() -> void {
+    if (!enabled) {
+        return;
+    }
+    // Swap rather than move so both frames keep their bucket arrays
+    std::swap(current_frame, last_frame);
+    current_frame.total_time_ms = 0.0;
+    current_frame.total_alloc_bytes = 0;
+    current_frame.types.clear();
+    current_frame.actors.clear();
+}
+
+auto Stats::DrawOverlay() -> void {
+    if (!enabled || overlay_font == "") {
+        return;
+    }
+    constexpr auto font_size = 12;
+    constexpr auto line_height = 14;
+    constexpr auto max_lines = 8;
+    auto sorted_types = std::vector<std::pair<const std::string *, const StatsSample *>>();
+    sorted_types.reserve(last_frame.types.size());
+    for (const auto &[type, sample] : last_frame.types) {
+        sorted_types.emplace_back(&type, &sample);
+    }
+    std::sort(sorted_types.begin(), sorted_types.end(), [](const auto &a, const auto &b) {
+        return a.second->time_ms > b.second->time_ms;
+    });
+    char line[128];
+    std::snprintf(line, sizeof(line), "lua %.2f ms  %.1f KB", last_frame.total_time_ms, last_frame.total_alloc_bytes / 1024.0);
+    TextDB::DrawText(line, 4, 4, overlay_font.c_str(), font_size, 255, 64, 64, 255);
+    auto y = 4 + line_height;
+    std::snprintf(line, sizeof(line), "heap %.1f KB  %zu blocks  pools %.1f KB  %zu allocs/frame  gc %.2f ms", LuaAllocator::GetLiveBytes() / 1024.0,
+                  LuaAllocator::GetLiveBlocks(), LuaAllocator::GetPoolBytes() / 1024.0, LuaAllocator::GetFrameAllocations(), LuaGC::GetLastStepMs());
+    TextDB::DrawText(line, 4, static_cast<float>(y), overlay_font.c_str(), font_size, 255, 64, 64, 255);
+    y += line_height;
+    for (auto i = size_t{0}; i < sorted_types.size() && i < max_lines; ++i) {
+        const auto &[type, sample] = sorted_types[i];
+        std::snprintf(line, sizeof(line), "%s  %.2f ms  %d calls  %.1f KB", type->c_str(), sample->time_ms, sample->calls, sample->alloc_bytes / 1024.0);
+        TextDB::DrawText(line, 4, static_cast<float>(y), overlay_font.c_str(), font_size, 255, 64, 64, 255);
+        y += line_height;
+    }
+}
+
+auto Stats::GetStats() -> luabridge::LuaRef {
+    const auto lua_state = LuaDB::GetLuaState();
+    auto stats = luabridge::newTable(lua_state);
+    stats["enabled"] = enabled;
+    stats["time_ms"] = last_frame.total_time_ms;
+    stats["alloc_bytes"] = last_frame.total_alloc_bytes;
+    auto types = luabridge::newTable(lua_state);
+    for (const auto &[type, sample] : last_frame.types) {
+        auto entry = luabridge::newTable(lua_state);
+        entry["calls"] = sample.calls;
+        entry["time_ms"] = sample.time_ms;
+        entry["alloc_bytes"] = sample.alloc_bytes;
+        types[type] = entry;
+    }
+    stats["components"] = types;
+    // Whole-state allocator counters, tracked whether or not stats are enabled
+    auto heap = luabridge::newTable(lua_state);
+    heap["live_bytes"] = LuaAllocator::GetLiveBytes();
+    heap["live_blocks"] = LuaAllocator::GetLiveBlocks();
+    heap["pool_bytes"] = LuaAllocator::GetPoolBytes();
+    heap["frame_alloc_bytes"] = LuaAllocator::GetFrameAllocatedBytes();
+    heap["frame_allocs"] = LuaAllocator::GetFrameAllocations();
+    heap["gc_mode"] = LuaGC::IsGenerational() ? "generational" : "incremental";
+    heap["gc_ms"] = LuaGC::GetLastStepMs();
+    heap["gc_steps"] = LuaGC::GetLastSteps();
+    heap["gc_collections"] = LuaGC::GetCollections();
+    stats["heap"] = heap;
+    auto sorted_actors = std::vector<std::pair<size_t, const StatsSample *>>();
+    sorted_actors.reserve(last_frame.actors.size());
+    for (const auto &[id, sample] : last_frame.actors) {
+        sorted_actors.emplace_back(id, &sample);
+    }
+    std::sort(sorted_actors.begin(), sorted_actors.end(), [](const auto &a, const auto &b) {
+        return a.second->time_ms > b.second->time_ms;
+    });
+    auto actors = luabridge::newTable(lua_state);
+    auto i = 1;
+    for (const auto &[id, sample] : sorted_actors) {
+        auto entry = luabridge::newTable(lua_state);
+        entry["id"] = static_cast<int>(id);
+        entry["name"] = sample->name;
+        entry["calls"] = sample->calls;
+        entry["time_ms"] = sample->time_ms;
+        entry["alloc_bytes"] = sample->alloc_bytes;
+        actors[i] = entry;
+        ++i;
+    }
+    stats["actors"] = actors;
+    return stats;
+}
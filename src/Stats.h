@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+#include "Component.h"
+#include "LuaDB.h"
+
+class StatsSample {
+  public:
+    std::string name;
+    int calls = 0;
+    double time_ms = 0.0;
+    size_t alloc_bytes = 0;
+};
+
+class FrameStats {
+  public:
+    double total_time_ms = 0.0;
+    size_t total_alloc_bytes = 0;
+    std::unordered_map<std::string, StatsSample> types;
+    std::unordered_map<size_t, StatsSample> actors;
+};
+
+class Stats {
+  public:
+    // Charges the wall time and Lua allocations of the enclosing block to a component
+    class Scope {
+      public:
+        explicit Scope(const Component &);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        auto operator=(const Scope &) -> Scope & = delete;
+
+      private:
+        const Component &component;
+        bool active;
+        std::chrono::time_point<std::chrono::steady_clock> start;
+        size_t start_alloc_bytes = 0;
+    };
+
+    static auto SetEnabled(bool) -> void;
+
+    static inline auto IsEnabled() -> bool {
+        return enabled;
+    }
+
+    static auto SetOverlayFont(const std::string &) -> void;
+
+    static auto EndFrame() -> void;
+
+    static auto DrawOverlay() -> void;
+
+    // Lua API
+    static auto GetStats() -> luabridge::LuaRef;
+
+  private:
+    static inline bool enabled = false;
+    static inline std::string overlay_font;
+    static inline FrameStats current_frame;
+    static inline FrameStats last_frame;
+};
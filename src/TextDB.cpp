@@ -1,7 +1,9 @@
 #include "TextDB.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <limits>
 
 #include "rapidjson/document.h"
 
@@ -27,16 +29,38 @@ auto TextDB::LoadFont(const std::string &font_name, const int font_size) -> TTF_
     return font;
 }
 
+auto TextDB::LoadFontHandle(const char *font_name, float font_size) -> int {
+    if (font_name == nullptr) {
+        return -1;
+    }
+    const auto size = static_cast<int>(font_size);
+    auto &handles = font_handles[font_name];
+    if (const auto handle_it = handles.find(size); handle_it != handles.end()) {
+        return handle_it->second;
+    }
+    const auto handle = static_cast<int>(font_handle_keys.size());
+    font_handle_keys.emplace_back(font_name, size);
+    font_handle_atlases.push_back(nullptr);
+    handles[size] = handle;
+    return handle;
+}
+
 auto TextDB::DrawText(const char *text, float x, float y, const char *font_name, float font_size, float r, float g, float b, float a) -> void {
     if (text == nullptr || font_name == nullptr) {
         return;
     }
+    DrawTextById(text, x, y, LoadFontHandle(font_name, font_size), r, g, b, a);
+}
+
+auto TextDB::DrawTextById(const char *text, float x, float y, int font, float r, float g, float b, float a) -> void {
+    if (text == nullptr || font < 0 || font >= static_cast<int>(font_handle_keys.size())) {
+        return;
+    }
     draw_calls.push_back({
         text,
         static_cast<int>(x),
         static_cast<int>(y),
-        font_name,
-        static_cast<int>(font_size),
+        font,
         static_cast<int>(r),
         static_cast<int>(g),
         static_cast<int>(b),
@@ -44,35 +68,136 @@ auto TextDB::DrawText(const char *text, float x, float y, const char *font_name,
     });
 }
 
-auto TextDB::GenerateText(TTF_Font *font, const std::string &text, int r, int g, int b, int a) -> SDL_Texture * {
-    const auto color = SDL_Color{
-        static_cast<unsigned char>(r),
-        static_cast<unsigned char>(g),
-        static_cast<unsigned char>(b),
-        static_cast<unsigned char>(a),
-    };
-    /*if (const auto font_it = generated_text.find(font); font_it != generated_text.end()) {
-        if (const auto color_it = font_it->second.find(color); color_it != font_it->second.end()) {
-            if (const auto texture_it = color_it->second.find(text); texture_it != color_it->second.end()) {
-                return texture_it->second;
+auto TextDB::LoadGlyphAtlas(const std::string &font_name, int font_size) -> GlyphAtlas & {
+    if (const auto font_it = glyph_atlases.find(font_name); font_it != glyph_atlases.end()) {
+        if (const auto atlas_it = font_it->second.find(font_size); atlas_it != font_it->second.end()) {
+            return atlas_it->second;
+        }
+    }
+    auto renderer_info = SDL_RendererInfo{};
+    SDL_GetRendererInfo(Engine::renderer, &renderer_info);
+    // A limit of zero means the renderer does not report one
+    const auto atlas_width = renderer_info.max_texture_width > 0 ? std::min(512, renderer_info.max_texture_width) : 512;
+    const auto max_page_height = renderer_info.max_texture_height > 0 ? renderer_info.max_texture_height : std::numeric_limits<int>::max();
+    auto &atlas = glyph_atlases[font_name][font_size];
+    atlas.font = LoadFont(font_name, font_size);
+    // Same characters TTF_RenderText treats as printable, since it reads text as Latin-1
+    auto glyph_surfaces = std::array<SDL_Surface *, 256>();
+    glyph_surfaces.fill(nullptr);
+    auto page_heights = std::vector<int>{1};
+    auto shelf_x = 0;
+    auto shelf_y = 0;
+    auto shelf_h = 0;
+    for (auto c = 0; c < 256; ++c) {
+        atlas.glyphs[c] = GlyphInfo{SDL_Rect{0, 0, 0, 0}, 0, 0, 0};
+        if (c < 32 || (c > 126 && c < 160)) {
+            continue;
+        }
+        auto min_x = 0;
+        auto max_x = 0;
+        auto min_y = 0;
+        auto max_y = 0;
+        if (TTF_GlyphMetrics32(atlas.font, static_cast<Uint32>(c), &min_x, &max_x, &min_y, &max_y, &atlas.glyphs[c].advance) != 0) {
+            continue;
+        }
+        atlas.glyphs[c].offset_x = std::min(min_x, 0);
+        const auto surface = TTF_RenderGlyph32_Solid(atlas.font, static_cast<Uint32>(c), SDL_Color{255, 255, 255, 255});
+        if (surface == nullptr) {
+            continue;
+        }
+        if (surface->w > atlas_width || surface->h > max_page_height) {
+            std::cout << "error: glyph of font " << font_name << " at size " << font_size << " exceeds the maximum texture size";
+            exit(0);
+        }
+        if (shelf_x + surface->w + 1 > atlas_width) {
+            shelf_y += shelf_h;
+            shelf_x = 0;
+            shelf_h = 0;
+        }
+        if (shelf_y + surface->h > max_page_height) {
+            page_heights.push_back(1);
+            shelf_y = 0;
+            shelf_x = 0;
+            shelf_h = 0;
+        }
+        atlas.glyphs[c].rect = SDL_Rect{shelf_x, shelf_y, surface->w, surface->h};
+        atlas.glyphs[c].page = static_cast<int>(page_heights.size()) - 1;
+        shelf_x += surface->w + 1;
+        shelf_h = std::max(shelf_h, surface->h + 1);
+        page_heights.back() = std::min(std::max(page_heights.back(), shelf_y + shelf_h), max_page_height);
+        glyph_surfaces[c] = surface;
+    }
+    for (auto page = 0; page < static_cast<int>(page_heights.size()); ++page) {
+        const auto page_height = page_heights[page];
+        const auto page_surface = SDL_CreateRGBSurfaceWithFormat(0, atlas_width, page_height, 32, SDL_PIXELFORMAT_RGBA32);
+        if (page_surface == nullptr) {
+            std::cout << "error: failed to create glyph atlas for font " << font_name << " " << SDL_GetError();
+            exit(0);
+        }
+        SDL_FillRect(page_surface, nullptr, 0);
+        for (auto c = 0; c < 256; ++c) {
+            if (glyph_surfaces[c] != nullptr && atlas.glyphs[c].page == page) {
+                auto dest_rect = atlas.glyphs[c].rect;
+                SDL_BlitSurface(glyph_surfaces[c], nullptr, page_surface, &dest_rect);
+                SDL_FreeSurface(glyph_surfaces[c]);
+                glyph_surfaces[c] = nullptr;
             }
         }
-    }*/
-    const auto surface = TTF_RenderText_Solid(font, text.c_str(), color);
-    const auto texture = SDL_CreateTextureFromSurface(Engine::renderer, surface);
-    // generated_text[font][color][text] = texture;
-    return texture;
+        const auto texture = SDL_CreateTextureFromSurface(Engine::renderer, page_surface);
+        SDL_FreeSurface(page_surface);
+        if (texture == nullptr) {
+            std::cout << "error: failed to create glyph atlas texture for font " << font_name << " " << SDL_GetError();
+            exit(0);
+        }
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        atlas.pages.push_back(TextureDB::LoadedTexture{texture, 0, 0, atlas_width, page_height, atlas_width, page_height});
+    }
+    return atlas;
+}
+
+auto TextDB::GetKerning(GlyphAtlas &atlas, unsigned char previous, unsigned char current) -> int {
+    const auto key = static_cast<uint32_t>(previous) << 8 | current;
+    if (const auto it = atlas.kerning.find(key); it != atlas.kerning.end()) {
+        return it->second;
+    }
+    const auto kerning = TTF_GetFontKerningSizeGlyphs32(atlas.font, previous, current);
+    atlas.kerning[key] = kerning;
+    return kerning;
 }
 
 auto TextDB::RenderText() -> void {
+    if (Engine::renderer == nullptr) {
+        draw_calls.clear();
+        return;
+    }
     for (const auto &draw_call : draw_calls) {
-        const auto font = LoadFont(draw_call.font_name, draw_call.font_size);
-        auto texture = GenerateText(font, draw_call.text, draw_call.r, draw_call.g, draw_call.b, draw_call.a);
-        auto destRect = SDL_Rect();
-        destRect.x = draw_call.x;
-        destRect.y = draw_call.y;
-        TTF_SizeText(font, draw_call.text.c_str(), &destRect.w, &destRect.h);
-        SDL_RenderCopy(Engine::renderer, texture, nullptr, &destRect);
+        if (font_handle_atlases[draw_call.font] == nullptr) {
+            const auto &[font_name, font_size] = font_handle_keys[draw_call.font];
+            font_handle_atlases[draw_call.font] = &LoadGlyphAtlas(font_name, font_size);
+        }
+        auto &atlas = *font_handle_atlases[draw_call.font];
+        const auto color = SDL_Color{
+            static_cast<Uint8>(draw_call.r),
+            static_cast<Uint8>(draw_call.g),
+            static_cast<Uint8>(draw_call.b),
+            static_cast<Uint8>(draw_call.a),
+        };
+        auto pen_x = draw_call.x;
+        auto previous = static_cast<unsigned char>(0);
+        for (const auto ch : draw_call.text) {
+            const auto c = static_cast<unsigned char>(ch);
+            if (previous != 0) {
+                pen_x += GetKerning(atlas, previous, c);
+            }
+            const auto &glyph = atlas.glyphs[c];
+            if (glyph.rect.w > 0) {
+                const auto dest_rect = SDL_Rect{pen_x + glyph.offset_x, draw_call.y, glyph.rect.w, glyph.rect.h};
+                TextureDB::BatchQuad(atlas.pages[glyph.page], glyph.rect, dest_rect, SDL_Point{0, 0}, 0.0f, SDL_FLIP_NONE, color);
+            }
+            pen_x += glyph.advance;
+            previous = c;
+        }
     }
+    TextureDB::FlushBatch();
     draw_calls.clear();
-}
\ No newline at end of file
+}
@@ -1,33 +1,65 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "SDL_image.h"
 #include "SDL_ttf.h"
 
+#include "TextureDB.h"
+
 class TextDB {
   public:
     static auto LoadFont(const std::string &, const int) -> TTF_Font *;
 
+    // Lua API
+    static auto LoadFontHandle(const char *, float) -> int;
+
     static auto DrawText(const char *, float, float, const char *, float, float, float, float, float) -> void;
 
-    static auto GenerateText(TTF_Font *, const std::string &, int, int, int, int) -> SDL_Texture *;
+    static auto DrawTextById(const char *, float, float, int, float, float, float, float) -> void;
 
     static auto RenderText() -> void;
 
   private:
     static inline std::unordered_map<std::string, std::unordered_map<int, TTF_Font *>> loaded_fonts;
-    // static inline std::unordered_map<TTF_Font *, std::unordered_map<SDL_Color, std::unordered_map<std::string, SDL_Texture *>>> generated_text;
+
+    class GlyphInfo {
+      public:
+        SDL_Rect rect;
+        int page;
+        // Rendering a single glyph shifts it right by any negative left bearing, which the layout undoes
+        int offset_x;
+        int advance;
+    };
+
+    // Every printable Latin-1 character of one font size, rendered white once and tinted per draw. Large
+    // sizes spill onto further pages rather than exceed the renderer's texture size limit
+    class GlyphAtlas {
+      public:
+        TTF_Font *font;
+        std::vector<TextureDB::LoadedTexture> pages;
+        std::array<GlyphInfo, 256> glyphs;
+        std::unordered_map<uint32_t, int> kerning;
+    };
+
+    static inline std::unordered_map<std::string, std::unordered_map<int, GlyphAtlas>> glyph_atlases;
+
+    // A font handle names one (font, size) pair; its atlas is built on first draw
+    static inline std::unordered_map<std::string, std::unordered_map<int, int>> font_handles;
+    static inline std::vector<std::pair<std::string, int>> font_handle_keys;
+    static inline std::vector<GlyphAtlas *> font_handle_atlases;
 
     class TextDrawCall {
       public:
         std::string text;
         int x;
         int y;
-        std::string font_name;
-        int font_size;
+        int font;
         int r;
         int g;
         int b;
@@ -35,4 +67,8 @@ class TextDB {
     };
 
     static inline std::vector<TextDrawCall> draw_calls;
+
+    static auto LoadGlyphAtlas(const std::string &, int) -> GlyphAtlas &;
+
+    static auto GetKerning(GlyphAtlas &, unsigned char, unsigned char) -> int;
 };
@@ -1,43 +1,194 @@
 #include "TextureDB.h"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <cstring>
+#include <cmath>
 #include <filesystem>
 #include <iostream>
+#include <unordered_set>
+#include <utility>
 
 #include "rapidjson/document.h"
 #include "SDL_image.h"
 #include "SDL.h"
 
 #include "Engine.h"
+#include "EngineUtils.h"
 #include "Physics.h"
 
-auto TextureDB::LoadTexture(const std::string &texture_name) -> SDL_Texture * {
+auto TextureDB::BuildAtlas() -> void {
+    class AtlasImage {
+      public:
+        std::string name;
+        SDL_Surface *surface;
+        int page = 0;
+        int x = 0;
+        int y = 0;
+    };
+    auto images = std::vector<AtlasImage>();
+    auto image_names = std::unordered_set<std::string>();
+    for (const auto &image_dir : {std::filesystem::path("core/images"), std::filesystem::path("resources/images")}) {
+        if (!std::filesystem::exists(image_dir)) {
+            continue;
+        }
+        for (const auto &entry : std::filesystem::recursive_directory_iterator(image_dir)) {
+            if (!entry.is_regular_file() || entry.path().extension() != ".png") {
+                continue;
+            }
+            // Same key LoadTexture would use, and core/images wins over resources/images like it does there
+            auto image_name = std::filesystem::relative(entry.path(), image_dir).replace_extension().generic_string();
+            std::transform(image_name.begin(), image_name.end(), image_name.begin(), [](unsigned char c) { return std::tolower(c); });
+            if (image_names.count(image_name) > 0) {
+                continue;
+            }
+            image_names.insert(image_name);
+            const auto surface = IMG_Load(entry.path().string().c_str());
+            if (surface == nullptr) {
+                continue;
+            }
+            if (surface->w > max_atlas_image_size || surface->h > max_atlas_image_size) {
+                SDL_FreeSurface(surface);
+                continue;
+            }
+            images.push_back({image_name, surface});
+        }
+    }
+    if (images.empty()) {
+        return;
+    }
+    auto renderer_info = SDL_RendererInfo();
+    SDL_GetRendererInfo(Engine::renderer, &renderer_info);
+    auto page_size = max_atlas_page_size;
+    if (renderer_info.max_texture_width > 0 && renderer_info.max_texture_height > 0) {
+        page_size = std::min({page_size, renderer_info.max_texture_width, renderer_info.max_texture_height});
+    }
+    // Shelf packing: tallest images first, filling rows left to right and opening a new page when one is full
+    std::sort(images.begin(), images.end(), [](const AtlasImage &a, const AtlasImage &b) {
+        return a.surface->h != b.surface->h ? a.surface->h > b.surface->h : a.name < b.name;
+    });
+    auto page_heights = std::vector<int>{0};
+    auto shelf_x = 0;
+    auto shelf_y = 0;
+    auto shelf_h = 0;
+    for (auto &image : images) {
+        const auto w = image.surface->w + atlas_padding * 2;
+        const auto h = image.surface->h + atlas_padding * 2;
+        if (shelf_x + w > page_size) {
+            shelf_y += shelf_h;
+            shelf_x = 0;
+            shelf_h = 0;
+        }
+        if (shelf_y + h > page_size) {
+            page_heights.push_back(0);
+            shelf_x = 0;
+            shelf_y = 0;
+            shelf_h = 0;
+        }
+        image.page = static_cast<int>(page_heights.size()) - 1;
+        image.x = shelf_x + atlas_padding;
+        image.y = shelf_y + atlas_padding;
+        shelf_x += w;
+        shelf_h = std::max(shelf_h, h);
+        page_heights.back() = std::max(page_heights.back(), shelf_y + shelf_h);
+    }
+    auto page_surfaces = std::vector<SDL_Surface *>();
+    for (const auto page_height : page_heights) {
+        const auto page_surface = SDL_CreateRGBSurfaceWithFormat(0, page_size, page_height, 32, SDL_PIXELFORMAT_RGBA32);
+        SDL_FillRect(page_surface, nullptr, 0);
+        page_surfaces.push_back(page_surface);
+    }
+    for (const auto &image : images) {
+        // Copy pixels and alpha as they are rather than blending onto the empty page
+        SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+        auto dest_rect = SDL_Rect{image.x, image.y, image.surface->w, image.surface->h};
+        SDL_BlitSurface(image.surface, nullptr, page_surfaces[image.page], &dest_rect);
+    }
+    auto page_textures = std::vector<SDL_Texture *>();
+    for (const auto page_surface : page_surfaces) {
+        const auto page_texture = SDL_CreateTextureFromSurface(Engine::renderer, page_surface);
+        if (page_texture == nullptr) {
+            std::cout << "error: failed to create texture atlas page " << SDL_GetError();
+            exit(0);
+        }
+        SDL_SetTextureBlendMode(page_texture, SDL_BLENDMODE_BLEND);
+        page_textures.push_back(page_texture);
+        SDL_FreeSurface(page_surface);
+    }
+    for (const auto &image : images) {
+        const auto page_texture = page_textures[image.page];
+        textures[GetTextureHandle(image.name)] = LoadedTexture{page_texture, image.x, image.y, image.surface->w, image.surface->h, page_size, page_heights[image.page]};
+        SDL_FreeSurface(image.surface);
+    }
+}
+
+auto TextureDB::GetTextureHandle(const std::string &texture_name) -> int {
+    if (const auto handle_it = texture_handles.find(texture_name); handle_it != texture_handles.end()) {
+        return handle_it->second;
+    }
     auto texture_name_lower = texture_name;
     std::transform(texture_name_lower.begin(), texture_name_lower.end(), texture_name_lower.begin(),
                    [](unsigned char c) { return std::tolower(c); });
-    if (const auto texture_it = loaded_textures.find(texture_name_lower); texture_it != loaded_textures.end()) {
-        return texture_it->second;
+    auto handle = static_cast<int>(textures.size());
+    if (const auto handle_it = texture_handles.find(texture_name_lower); handle_it != texture_handles.end()) {
+        handle = handle_it->second;
+    } else {
+        texture_names.push_back(texture_name_lower);
+        textures.push_back(LoadedTexture{nullptr, 0, 0, 0, 0, 0, 0});
+        texture_handles.insert({texture_name_lower, handle});
     }
-    auto texture_file = "core/images/" + texture_name_lower + ".png";
+    texture_handles.insert({texture_name, handle});
+    return handle;
+}
+
+auto TextureDB::GetLoadedTexture(int handle) -> LoadedTexture {
+    auto &loaded_texture = textures[handle];
+    if (loaded_texture.texture != nullptr) {
+        return loaded_texture;
+    }
+    const auto &texture_name = texture_names[handle];
+    auto texture_file = "core/images/" + texture_name + ".png";
     if (!std::filesystem::exists(texture_file)) {
-        texture_file = "resources/images/" + texture_name_lower + ".png";
+        texture_file = "resources/images/" + texture_name + ".png";
         if (!std::filesystem::exists(texture_file)) {
-            std::cout << "error: missing image " << texture_name_lower;
+            std::cout << "error: missing image " << texture_name;
             exit(0);
         }
     }
-    auto texture = IMG_LoadTexture(Engine::renderer, texture_file.c_str());
-    loaded_textures.insert({texture_name_lower, texture});
-    return texture;
+    loaded_texture.texture = IMG_LoadTexture(Engine::renderer, texture_file.c_str());
+    loaded_texture.x = 0;
+    loaded_texture.y = 0;
+    SDL_QueryTexture(loaded_texture.texture, nullptr, nullptr, &loaded_texture.w, &loaded_texture.h);
+    loaded_texture.texture_w = loaded_texture.w;
+    loaded_texture.texture_h = loaded_texture.h;
+    return loaded_texture;
+}
+
+auto TextureDB::GetLoadedTexture(const std::string &texture_name) -> LoadedTexture {
+    return GetLoadedTexture(GetTextureHandle(texture_name));
+}
+
+auto TextureDB::LoadImageHandle(const char *image_name) -> int {
+    if (image_name == nullptr) {
+        return -1;
+    }
+    return GetTextureHandle(image_name);
 }
 
 auto TextureDB::DrawUI(const char *image_name, float x, float y) -> void {
     if (image_name == nullptr) {
         return;
     }
+    DrawUIById(GetTextureHandle(image_name), x, y);
+}
+
+auto TextureDB::DrawUIById(int image, float x, float y) -> void {
+    if (!IsValidHandle(image)) {
+        return;
+    }
     auto draw_call = UIDrawCall{};
-    draw_call.image_name = image_name;
+    draw_call.image = image;
     draw_call.x = static_cast<int>(x);
     draw_call.y = static_cast<int>(y);
     ui_draw_calls.push_back(draw_call);
@@ -47,8 +198,15 @@ auto TextureDB::DrawUIEx(const char *image_name, float x, float y, float rotatio
     if (image_name == nullptr) {
         return;
     }
+    DrawUIExById(GetTextureHandle(image_name), x, y, rotation_degrees, scale_x, scale_y, pivot_x, pivot_y, r, g, b, a, sorting_order);
+}
+
+auto TextureDB::DrawUIExById(int image, float x, float y, float rotation_degrees, float scale_x, float scale_y, float pivot_x, float pivot_y, float r, float g, float b, float a, float sorting_order) -> void {
+    if (!IsValidHandle(image)) {
+        return;
+    }
     auto draw_call = UIDrawCall{};
-    draw_call.image_name = image_name;
+    draw_call.image = image;
     draw_call.x = static_cast<int>(x);
     draw_call.y = static_cast<int>(y);
     draw_call.rotation_degrees = static_cast<int>(rotation_degrees);
@@ -68,8 +226,15 @@ auto TextureDB::DrawImage(const char *image_name, float x, float y) -> void {
     if (image_name == nullptr) {
         return;
     }
+    DrawImageById(GetTextureHandle(image_name), x, y);
+}
+
+auto TextureDB::DrawImageById(int image, float x, float y) -> void {
+    if (!IsValidHandle(image)) {
+        return;
+    }
     auto draw_call = ImageDrawCall{};
-    draw_call.image_name = image_name;
+    draw_call.image = image;
     draw_call.x = x;
     draw_call.y = y;
     image_draw_calls.push_back(draw_call);
@@ -79,8 +244,15 @@ auto TextureDB::DrawImageEx(const char *image_name, float x, float y, float rota
     if (image_name == nullptr) {
         return;
     }
+    DrawImageExById(GetTextureHandle(image_name), x, y, rotation_degrees, scale_x, scale_y, pivot_x, pivot_y, r, g, b, a, sorting_order);
+}
+
+auto TextureDB::DrawImageExById(int image, float x, float y, float rotation_degrees, float scale_x, float scale_y, float pivot_x, float pivot_y, float r, float g, float b, float a, float sorting_order) -> void {
+    if (!IsValidHandle(image)) {
+        return;
+    }
     auto draw_call = ImageDrawCall{};
-    draw_call.image_name = image_name;
+    draw_call.image = image;
     draw_call.x = x;
     draw_call.y = y;
     draw_call.rotation_degrees = static_cast<int>(rotation_degrees);
@@ -96,12 +268,66 @@ auto TextureDB::DrawImageEx(const char *image_name, float x, float y, float rota
     image_draw_calls.push_back(draw_call);
 }
 
+auto TextureDB::DrawBatch(lua_State *lua_state) -> int {
+    const auto image = lua_type(lua_state, 1) == LUA_TSTRING ? GetTextureHandle(lua_tostring(lua_state, 1)) : static_cast<int>(luaL_checkinteger(lua_state, 1));
+    if (!IsValidHandle(image)) {
+        return 0;
+    }
+    auto values = std::array<float, batch_stride>();
+    const auto push_draw_call = [&]() {
+        auto draw_call = ImageDrawCall{};
+        draw_call.image = image;
+        draw_call.x = values[0];
+        draw_call.y = values[1];
+        draw_call.rotation_degrees = static_cast<int>(values[2]);
+        draw_call.scale_x = values[3];
+        draw_call.scale_y = values[4];
+        draw_call.r = static_cast<int>(values[5]);
+        draw_call.g = static_cast<int>(values[6]);
+        draw_call.b = static_cast<int>(values[7]);
+        draw_call.a = static_cast<int>(values[8]);
+        draw_call.sorting_order = static_cast<int>(values[9]);
+        image_draw_calls.push_back(draw_call);
+    };
+    // A string holds the floats packed natively, as produced by string.pack with "f" per value
+    if (lua_type(lua_state, 2) == LUA_TSTRING) {
+        auto length = size_t{0};
+        const auto bytes = lua_tolstring(lua_state, 2, &length);
+        const auto count = length / sizeof(values);
+        image_draw_calls.reserve(image_draw_calls.size() + count);
+        for (auto i = size_t{0}; i < count; ++i) {
+            std::memcpy(values.data(), bytes + i * sizeof(values), sizeof(values));
+            push_draw_call();
+        }
+        return 0;
+    }
+    luaL_checktype(lua_state, 2, LUA_TTABLE);
+    const auto count = static_cast<lua_Integer>(lua_rawlen(lua_state, 2)) / batch_stride;
+    image_draw_calls.reserve(image_draw_calls.size() + static_cast<size_t>(count));
+    for (auto i = lua_Integer{0}; i < count; ++i) {
+        for (auto j = 0; j < batch_stride; ++j) {
+            lua_rawgeti(lua_state, 2, i * batch_stride + j + 1);
+            values[j] = static_cast<float>(lua_tonumber(lua_state, -1));
+            lua_pop(lua_state, 1);
+        }
+        push_draw_call();
+    }
+    return 0;
+}
+
 auto TextureDB::DrawTile(const char *tileset_name, float tile_x, float tile_y, float tile_w, float tile_h, float x, float y) -> void {
     if (tileset_name == nullptr) {
         return;
     }
+    DrawTileById(GetTextureHandle(tileset_name), tile_x, tile_y, tile_w, tile_h, x, y);
+}
+
+auto TextureDB::DrawTileById(int tileset, float tile_x, float tile_y, float tile_w, float tile_h, float x, float y) -> void {
+    if (!IsValidHandle(tileset)) {
+        return;
+    }
     auto draw_call = TileDrawCall{};
-    draw_call.tileset_name = tileset_name;
+    draw_call.tileset = tileset;
     draw_call.tile_x = static_cast<int>(tile_x);
     draw_call.tile_y = static_cast<int>(tile_y);
     draw_call.tile_w = static_cast<int>(tile_w);
@@ -117,8 +343,15 @@ auto TextureDB::DrawTileEx(const char *tileset_name, float tile_x, float tile_y,
     if (tileset_name == nullptr) {
         return;
     }
+    DrawTileExById(GetTextureHandle(tileset_name), tile_x, tile_y, tile_w, tile_h, x, y, w, h, rotation_degrees, scale_x, scale_y, pivot_x, pivot_y, r, g, b, a, sorting_order);
+}
+
+auto TextureDB::DrawTileExById(int tileset, float tile_x, float tile_y, float tile_w, float tile_h, float x, float y, float w, float h, float rotation_degrees, float scale_x, float scale_y, float pivot_x, float pivot_y, float r, float g, float b, float a, float sorting_order) -> void {
+    if (!IsValidHandle(tileset)) {
+        return;
+    }
     auto draw_call = TileDrawCall{};
-    draw_call.tileset_name = tileset_name;
+    draw_call.tileset = tileset;
     draw_call.tile_x = static_cast<int>(tile_x);
     draw_call.tile_y = static_cast<int>(tile_y);
     draw_call.tile_w = static_cast<int>(tile_w);
@@ -140,26 +373,63 @@ auto TextureDB::DrawTileEx(const char *tileset_name, float tile_x, float tile_y,
     tile_draw_calls.push_back(draw_call);
 }
 
-auto TextureDB::DrawPixel(float x, float y, float r, float g, float b, float a) -> void {
-    auto draw_call = PixelDrawCall{};
-    draw_call.x = static_cast<int>(x);
-    draw_call.y = static_cast<int>(y);
-    draw_call.r = static_cast<int>(r);
-    draw_call.g = static_cast<int>(g);
-    draw_call.b = static_cast<int>(b);
+auto TextureDB::DrawTileTexture(SDL_Texture *texture, float x, float y, float w, float h, float a, float sorting_order) -> void {
+    auto draw_call = TileDrawCall{};
+    draw_call.texture = texture;
+    draw_call.tile_x = 0;
+    draw_call.tile_y = 0;
+    draw_call.tile_w = static_cast<int>(w);
+    draw_call.tile_h = static_cast<int>(h);
+    draw_call.x = x;
+    draw_call.y = y;
+    draw_call.w = draw_call.tile_w;
+    draw_call.h = draw_call.tile_h;
     draw_call.a = static_cast<int>(a);
-    pixel_draw_calls.push_back(draw_call);
+    draw_call.sorting_order = static_cast<int>(sorting_order);
+    tile_draw_calls.push_back(draw_call);
+}
+
+auto TextureDB::DrawPixel(float x, float y, float r, float g, float b, float a) -> void {
+    if (Engine::renderer == nullptr) {
+        return;
+    }
+    const auto pixel_x = static_cast<int>(x);
+    const auto pixel_y = static_cast<int>(y);
+    const auto width = Engine::config.window_width;
+    const auto height = Engine::config.window_height;
+    const auto alpha = static_cast<uint32_t>(std::clamp(static_cast<int>(a), 0, 255));
+    if (pixel_x < 0 || pixel_y < 0 || pixel_x >= width || pixel_y >= height || alpha == 0) {
+        return;
+    }
+    if (pixel_buffer.empty()) {
+        pixel_buffer.assign(static_cast<size_t>(width) * height, 0u);
+    }
+    const auto color = 0xFF000000u | static_cast<uint32_t>(std::clamp(static_cast<int>(r), 0, 255)) << 16 |
+                       static_cast<uint32_t>(std::clamp(static_cast<int>(g), 0, 255)) << 8 | static_cast<uint32_t>(std::clamp(static_cast<int>(b), 0, 255));
+    // Premultiplied "over": the sums cannot carry between channels since each is at most alpha + (255 - alpha)
+    auto &pixel = pixel_buffer[static_cast<size_t>(pixel_y) * width + pixel_x];
+    pixel = ScaleChannels(color, alpha) + ScaleChannels(pixel, 255 - alpha);
+    pixel_min_x = std::min(pixel_min_x, pixel_x);
+    pixel_min_y = std::min(pixel_min_y, pixel_y);
+    pixel_max_x = std::max(pixel_max_x, pixel_x);
+    pixel_max_y = std::max(pixel_max_y, pixel_y);
 }
 
 auto TextureDB::RenderScene() -> void {
-    std::stable_sort(image_draw_calls.begin(), image_draw_calls.end());
+    if (Engine::renderer == nullptr) {
+        image_draw_calls.clear();
+        return;
+    }
+    SortDrawCalls(image_draw_calls);
     const auto zoom_factor = Engine::config.zoom_factor;
     SDL_RenderSetScale(Engine::renderer, zoom_factor, zoom_factor);
-    for (const auto &draw_call : image_draw_calls) {
+    for (const auto key : sort_keys) {
+        const auto &draw_call = image_draw_calls[static_cast<uint32_t>(key)];
         const auto final_rendering_position = glm::vec2(draw_call.x, draw_call.y) - Engine::camera_position;
-        const auto texture = LoadTexture(draw_call.image_name);
+        const auto texture = GetLoadedTexture(draw_call.image);
         auto dest_rect = SDL_Rect();
-        SDL_QueryTexture(texture, nullptr, nullptr, &dest_rect.w, &dest_rect.h);
+        dest_rect.w = texture.w;
+        dest_rect.h = texture.h;
         auto flip_mode = static_cast<int>(SDL_FLIP_NONE);
         if (draw_call.scale_x < 0) {
             flip_mode |= SDL_FLIP_HORIZONTAL;
@@ -181,22 +451,33 @@ auto TextureDB::RenderScene() -> void {
         if (dest_rect.x > cam_dimensions.x / zoom_factor + 50 || dest_rect.y > cam_dimensions.y / zoom_factor + 50 || dest_rect.x + dest_rect.w < -50 || dest_rect.y + dest_rect.h < -50) {
             continue;
         }
-        SDL_SetTextureColorMod(texture, draw_call.r, draw_call.g, draw_call.b);
-        SDL_SetTextureAlphaMod(texture, draw_call.a);
-        SDL_RenderCopyEx(Engine::renderer, texture, nullptr, &dest_rect, draw_call.rotation_degrees, &pivot_point, static_cast<SDL_RendererFlip>(flip_mode));
-        SDL_SetTextureColorMod(texture, 255, 255, 255);
-        SDL_SetTextureAlphaMod(texture, 255);
+        const auto color = SDL_Color{static_cast<Uint8>(draw_call.r), static_cast<Uint8>(draw_call.g), static_cast<Uint8>(draw_call.b), static_cast<Uint8>(draw_call.a)};
+        const auto src_rect = SDL_Rect{0, 0, texture.w, texture.h};
+        BatchQuad(texture, src_rect, dest_rect, pivot_point, static_cast<float>(draw_call.rotation_degrees), flip_mode, color);
     }
+    FlushBatch();
     image_draw_calls.clear();
 }
 
 auto TextureDB::RenderTiles() -> void {
-    std::stable_sort(tile_draw_calls.begin(), tile_draw_calls.end());
+    if (Engine::renderer == nullptr) {
+        tile_draw_calls.clear();
+        return;
+    }
+    SortDrawCalls(tile_draw_calls);
     const auto zoom_factor = Engine::config.zoom_factor;
     SDL_RenderSetScale(Engine::renderer, zoom_factor, zoom_factor);
-    for (const auto &draw_call : tile_draw_calls) {
+    for (const auto key : sort_keys) {
+        const auto &draw_call = tile_draw_calls[static_cast<uint32_t>(key)];
         const auto final_rendering_position = glm::vec2(draw_call.x, draw_call.y) - Engine::camera_position;
-        const auto texture = LoadTexture(draw_call.tileset_name);
+        auto texture = LoadedTexture{draw_call.texture, 0, 0, 0, 0, 0, 0};
+        if (texture.texture != nullptr) {
+            SDL_QueryTexture(texture.texture, nullptr, nullptr, &texture.w, &texture.h);
+            texture.texture_w = texture.w;
+            texture.texture_h = texture.h;
+        } else {
+            texture = GetLoadedTexture(draw_call.tileset);
+        }
         auto dest_rect = SDL_Rect();
         dest_rect.w = draw_call.w;
         dest_rect.h = draw_call.h;
@@ -221,27 +502,27 @@ auto TextureDB::RenderTiles() -> void {
         if (dest_rect.x > cam_dimensions.x / zoom_factor + 50 || dest_rect.y > cam_dimensions.y / zoom_factor + 50 || dest_rect.x + dest_rect.w < -50 || dest_rect.y + dest_rect.h < -50) {
             continue;
         }
-        auto src_rect = SDL_Rect();
-        src_rect.x = draw_call.tile_x;
-        src_rect.y = draw_call.tile_y;
-        src_rect.w = draw_call.tile_w;
-        src_rect.h = draw_call.tile_h;
-        SDL_SetTextureColorMod(texture, draw_call.r, draw_call.g, draw_call.b);
-        SDL_SetTextureAlphaMod(texture, draw_call.a);
-        SDL_RenderCopyEx(Engine::renderer, texture, &src_rect, &dest_rect, draw_call.rotation_degrees, &pivot_point, static_cast<SDL_RendererFlip>(flip_mode));
-        SDL_SetTextureColorMod(texture, 255, 255, 255);
-        SDL_SetTextureAlphaMod(texture, 255);
+        const auto src_rect = SDL_Rect{draw_call.tile_x, draw_call.tile_y, draw_call.tile_w, draw_call.tile_h};
+        const auto color = SDL_Color{static_cast<Uint8>(draw_call.r), static_cast<Uint8>(draw_call.g), static_cast<Uint8>(draw_call.b), static_cast<Uint8>(draw_call.a)};
+        BatchQuad(texture, src_rect, dest_rect, pivot_point, static_cast<float>(draw_call.rotation_degrees), flip_mode, color);
     }
+    FlushBatch();
     tile_draw_calls.clear();
 }
 
 auto TextureDB::RenderUI() -> void {
-    std::stable_sort(ui_draw_calls.begin(), ui_draw_calls.end());
+    if (Engine::renderer == nullptr) {
+        ui_draw_calls.clear();
+        return;
+    }
+    SortDrawCalls(ui_draw_calls);
     SDL_RenderSetScale(Engine::renderer, 1, 1);
-    for (const auto &draw_call : ui_draw_calls) {
-        const auto texture = LoadTexture(draw_call.image_name);
+    for (const auto key : sort_keys) {
+        const auto &draw_call = ui_draw_calls[static_cast<uint32_t>(key)];
+        const auto texture = GetLoadedTexture(draw_call.image);
         auto dest_rect = SDL_Rect();
-        SDL_QueryTexture(texture, nullptr, nullptr, &dest_rect.w, &dest_rect.h);
+        dest_rect.w = texture.w;
+        dest_rect.h = texture.h;
         const auto x_scale = std::abs(draw_call.scale_x);
         const auto y_scale = std::abs(draw_call.scale_y);
         dest_rect.w = static_cast<int>(dest_rect.w * x_scale);
@@ -252,21 +533,113 @@ auto TextureDB::RenderUI() -> void {
         };
         dest_rect.x = draw_call.x;
         dest_rect.y = draw_call.y;
-        SDL_SetTextureColorMod(texture, draw_call.r, draw_call.g, draw_call.b);
-        SDL_SetTextureAlphaMod(texture, draw_call.a);
-        SDL_RenderCopyEx(Engine::renderer, texture, nullptr, &dest_rect, draw_call.rotation_degrees, &pivot_point, SDL_FLIP_NONE);
-        SDL_SetTextureColorMod(texture, 255, 255, 255);
-        SDL_SetTextureAlphaMod(texture, 255);
+        const auto color = SDL_Color{static_cast<Uint8>(draw_call.r), static_cast<Uint8>(draw_call.g), static_cast<Uint8>(draw_call.b), static_cast<Uint8>(draw_call.a)};
+        const auto src_rect = SDL_Rect{0, 0, texture.w, texture.h};
+        BatchQuad(texture, src_rect, dest_rect, pivot_point, static_cast<float>(draw_call.rotation_degrees), SDL_FLIP_NONE, color);
     }
+    FlushBatch();
     ui_draw_calls.clear();
 }
 
+auto TextureDB::RadixSortKeys() -> void {
+    // LSD radix sort on the sorting_order half only; the index half already ascends, which keeps the sort stable
+    const auto count = sort_keys.size();
+    sort_scratch.resize(count);
+    for (auto shift = 32; shift < 64; shift += 8) {
+        auto histogram = std::array<size_t, 256>();
+        for (const auto key : sort_keys) {
+            histogram[(key >> shift) & 0xFF]++;
+        }
+        if (histogram[(sort_keys[0] >> shift) & 0xFF] == count) {
+            continue; // Every key shares this byte, which is the common case for the upper ones
+        }
+        auto offset = size_t{0};
+        for (auto &bucket : histogram) {
+            const auto bucket_count = bucket;
+            bucket = offset;
+            offset += bucket_count;
+        }
+        for (const auto key : sort_keys) {
+            sort_scratch[histogram[(key >> shift) & 0xFF]++] = key;
+        }
+        std::swap(sort_keys, sort_scratch);
+    }
+}
+
+auto TextureDB::BatchQuad(const LoadedTexture &texture, const SDL_Rect &src_rect, const SDL_Rect &dest_rect, const SDL_Point &pivot_point, float rotation_degrees, int flip_mode, SDL_Color color) -> void {
+    if (texture.texture != batch_texture) {
+        FlushBatch();
+        batch_texture = texture.texture;
+    }
+    // src_rect is relative to the image, which may sit anywhere on an atlas page
+    auto u0 = static_cast<float>(texture.x + src_rect.x) / texture.texture_w;
+    auto v0 = static_cast<float>(texture.y + src_rect.y) / texture.texture_h;
+    auto u1 = static_cast<float>(texture.x + src_rect.x + src_rect.w) / texture.texture_w;
+    auto v1 = static_cast<float>(texture.y + src_rect.y + src_rect.h) / texture.texture_h;
+    if (flip_mode & SDL_FLIP_HORIZONTAL) {
+        std::swap(u0, u1);
+    }
+    if (flip_mode & SDL_FLIP_VERTICAL) {
+        std::swap(v0, v1);
+    }
+    // Matches SDL_RenderCopyEx: rotate clockwise about the pivot, which is relative to the destination's top left
+    auto cos_rotation = 1.0f;
+    auto sin_rotation = 0.0f;
+    if (rotation_degrees != 0.0f) {
+        const auto rotation_radians = EngineUtils::DegToRad(rotation_degrees);
+        cos_rotation = std::cos(rotation_radians);
+        sin_rotation = std::sin(rotation_radians);
+    }
+    const auto origin_x = static_cast<float>(dest_rect.x + pivot_point.x);
+    const auto origin_y = static_cast<float>(dest_rect.y + pivot_point.y);
+    const auto make_vertex = [&](int x, int y, float u, float v) {
+        const auto offset_x = static_cast<float>(x - pivot_point.x);
+        const auto offset_y = static_cast<float>(y - pivot_point.y);
+        return SDL_Vertex{
+            {origin_x + offset_x * cos_rotation - offset_y * sin_rotation, origin_y + offset_x * sin_rotation + offset_y * cos_rotation},
+            color,
+            {u, v},
+        };
+    };
+    const auto first_index = static_cast<int>(batch_vertices.size());
+    batch_vertices.push_back(make_vertex(0, 0, u0, v0));
+    batch_vertices.push_back(make_vertex(dest_rect.w, 0, u1, v0));
+    batch_vertices.push_back(make_vertex(dest_rect.w, dest_rect.h, u1, v1));
+    batch_vertices.push_back(make_vertex(0, dest_rect.h, u0, v1));
+    batch_indices.insert(batch_indices.end(), {first_index, first_index + 1, first_index + 2, first_index, first_index + 2, first_index + 3});
+}
+
+auto TextureDB::FlushBatch() -> void {
+    if (!batch_vertices.empty()) {
+        SDL_RenderGeometry(Engine::renderer, batch_texture, batch_vertices.data(), static_cast<int>(batch_vertices.size()), batch_indices.data(), static_cast<int>(batch_indices.size()));
+        batch_vertices.clear();
+        batch_indices.clear();
+    }
+    batch_texture = nullptr;
+}
+
 auto TextureDB::RenderPixels() -> void {
-    SDL_SetRenderDrawBlendMode(Engine::renderer, SDL_BLENDMODE_BLEND);
-    for (const auto &draw_call : pixel_draw_calls) {
-        SDL_SetRenderDrawColor(Engine::renderer, draw_call.r, draw_call.g, draw_call.b, draw_call.a);
-        SDL_RenderDrawPoint(Engine::renderer, draw_call.x, draw_call.y);
+    if (Engine::renderer == nullptr || pixel_max_x < pixel_min_x) {
+        return;
+    }
+    const auto width = Engine::config.window_width;
+    if (pixel_texture == nullptr) {
+        pixel_texture = SDL_CreateTexture(Engine::renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, Engine::config.window_height);
+        // The layer is premultiplied, so composite it as dst = src + dst * (1 - src_alpha), matching per-point blending
+        const auto premultiplied_blend = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                                                    SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+        SDL_SetTextureBlendMode(pixel_texture, premultiplied_blend);
+    }
+    const auto dirty_rect = SDL_Rect{pixel_min_x, pixel_min_y, pixel_max_x - pixel_min_x + 1, pixel_max_y - pixel_min_y + 1};
+    const auto first_pixel = static_cast<size_t>(pixel_min_y) * width + pixel_min_x;
+    SDL_UpdateTexture(pixel_texture, &dirty_rect, &pixel_buffer[first_pixel], width * static_cast<int>(sizeof(uint32_t)));
+    SDL_RenderCopy(Engine::renderer, pixel_texture, &dirty_rect, &dirty_rect);
+    // Only the rows touched this frame need clearing for the next one
+    for (auto row = pixel_min_y; row <= pixel_max_y; ++row) {
+        std::fill_n(pixel_buffer.begin() + static_cast<size_t>(row) * width + pixel_min_x, dirty_rect.w, 0u);
     }
-    SDL_SetRenderDrawBlendMode(Engine::renderer, SDL_BLENDMODE_NONE);
-    pixel_draw_calls.clear();
+    pixel_min_x = INT32_MAX;
+    pixel_min_y = INT32_MAX;
+    pixel_max_x = -1;
+    pixel_max_y = -1;
 }
\ No newline at end of file
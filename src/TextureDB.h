@@ -1,27 +1,76 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "lua/lua.hpp"
 #include "SDL_image.h"
 
 class TextureDB {
   public:
-    static auto LoadTexture(const std::string &) -> SDL_Texture *;
+    // An image's region of its texture, which is an atlas page for small images
+    class LoadedTexture {
+      public:
+        SDL_Texture *texture;
+        int x;
+        int y;
+        int w;
+        int h;
+        int texture_w;
+        int texture_h;
+    };
+
+    // Packs every small image under core/images and resources/images into shared atlas pages
+    static auto BuildAtlas() -> void;
+
+    // Interns an image name; the handle is valid for the rest of the run and loads lazily on first draw
+    static auto GetTextureHandle(const std::string &) -> int;
+
+    // Returned by value: a later GetTextureHandle may grow the table and move the entries
+    static auto GetLoadedTexture(int) -> LoadedTexture;
+
+    static auto GetLoadedTexture(const std::string &) -> LoadedTexture;
+
+    // Queues a quad from a source rect of the texture; consecutive quads on one texture are drawn together
+    static auto BatchQuad(const LoadedTexture &, const SDL_Rect &, const SDL_Rect &, const SDL_Point &, float, int, SDL_Color) -> void;
+
+    static auto FlushBatch() -> void;
+
+    // Lua API
+    static auto LoadImageHandle(const char *) -> int;
 
     static auto DrawUI(const char *, float, float) -> void;
 
+    static auto DrawUIById(int, float, float) -> void;
+
     static auto DrawUIEx(const char *, float, float, float, float, float, float, float, float, float, float, float, float) -> void;
 
+    static auto DrawUIExById(int, float, float, float, float, float, float, float, float, float, float, float, float) -> void;
+
     static auto DrawImage(const char *, float, float) -> void;
 
+    static auto DrawImageById(int, float, float) -> void;
+
     static auto DrawImageEx(const char *, float, float, float, float, float, float, float, float, float, float, float, float) -> void;
 
+    static auto DrawImageExById(int, float, float, float, float, float, float, float, float, float, float, float, float) -> void;
+
+    // Lua: Image.DrawBatch(image, buffer), queueing one scene image per batch_stride floats of buffer
+    static auto DrawBatch(lua_State *) -> int;
+
     static auto DrawTile(const char *, float, float, float, float, float, float) -> void;
 
+    static auto DrawTileById(int, float, float, float, float, float, float) -> void;
+
     static auto DrawTileEx(const char *, float, float, float, float, float, float, float, float, float, float, float, float, float, float, float, float, float, float) -> void;
 
+    static auto DrawTileExById(int, float, float, float, float, float, float, float, float, float, float, float, float, float, float, float, float, float, float) -> void;
+
+    // Queues an already loaded texture, such as a baked tilemap chunk, alongside the tiles
+    static auto DrawTileTexture(SDL_Texture *, float, float, float, float, float, float) -> void;
+
     static auto DrawPixel(float, float, float, float, float, float) -> void;
 
     static auto RenderScene() -> void;
@@ -32,12 +81,52 @@ class TextureDB {
 
     static auto RenderPixels() -> void;
 
+    // x, y, rotation_degrees, scale_x, scale_y, r, g, b, a, sorting_order
+    static constexpr int batch_stride = 10;
+
   private:
-    static inline std::unordered_map<std::string, SDL_Texture *> loaded_textures;
+    // Images larger than this on either side keep a texture of their own
+    static constexpr int max_atlas_image_size = 512;
+    static constexpr int max_atlas_page_size = 2048;
+    // Gap left around each packed image so neighbours never bleed into each other
+    static constexpr int atlas_padding = 1;
+
+    // Handles index textures and texture_names; texture_handles also keeps each spelling a name was requested with
+    static inline std::unordered_map<std::string, int> texture_handles;
+    static inline std::vector<std::string> texture_names;
+    static inline std::vector<LoadedTexture> textures;
+
+    static inline auto IsValidHandle(int handle) -> bool {
+        return handle >= 0 && handle < static_cast<int>(textures.size());
+    }
+
+    // Quads for consecutive draw calls sharing a texture, submitted together by FlushBatch
+    static inline SDL_Texture *batch_texture = nullptr;
+    static inline std::vector<SDL_Vertex> batch_vertices;
+    static inline std::vector<int> batch_indices;
+
+    // Screen-sized layer of premultiplied ARGB8888 that DrawPixel blends into on the CPU, uploaded once per frame
+    static inline SDL_Texture *pixel_texture = nullptr;
+    static inline std::vector<uint32_t> pixel_buffer;
+    // Inclusive bounds of the pixels written this frame; empty while min exceeds max
+    static inline int pixel_min_x = INT32_MAX;
+    static inline int pixel_min_y = INT32_MAX;
+    static inline int pixel_max_x = -1;
+    static inline int pixel_max_y = -1;
+
+    // Multiplies each 8-bit channel of a packed pixel by factor / 255, two channels per multiply
+    static inline auto ScaleChannels(uint32_t pixel, uint32_t factor) -> uint32_t {
+        auto rb = (pixel & 0x00FF00FFu) * factor + 0x00800080u;
+        rb = ((rb + ((rb >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+        auto ag = ((pixel >> 8) & 0x00FF00FFu) * factor + 0x00800080u;
+        ag = (ag + ((ag >> 8) & 0x00FF00FFu)) & 0xFF00FF00u;
+        return rb | ag;
+    }
+
 
     class ImageDrawCall {
       public:
-        std::string image_name;
+        int image;
         float x;
         float y;
         int rotation_degrees = 0;
@@ -50,15 +139,11 @@ class TextureDB {
         int b = 255;
         int a = 255;
         int sorting_order = 0;
-
-        auto operator<(const ImageDrawCall &other) const -> bool {
-            return sorting_order < other.sorting_order;
-        }
     };
 
     class UIDrawCall {
       public:
-        std::string image_name;
+        int image;
         int x;
         int y;
         int rotation_degrees = 0;
@@ -71,25 +156,12 @@ class TextureDB {
         int b = 255;
         int a = 255;
         int sorting_order = 0;
-
-        auto operator<(const UIDrawCall &other) const -> bool {
-            return sorting_order < other.sorting_order;
-        }
-    };
-
-    class PixelDrawCall {
-      public:
-        int x;
-        int y;
-        int r;
-        int g;
-        int b;
-        int a;
     };
 
     class TileDrawCall {
       public:
-        std::string tileset_name;
+        int tileset = -1;
+        SDL_Texture *texture = nullptr;
         int tile_x;
         int tile_y;
         int tile_w;
@@ -108,14 +180,28 @@ class TextureDB {
         int b = 255;
         int a = 255;
         int sorting_order = 0;
-
-        auto operator<(const TileDrawCall &other) const -> bool {
-            return sorting_order < other.sorting_order;
-        }
     };
 
     static inline std::vector<ImageDrawCall> image_draw_calls;
     static inline std::vector<UIDrawCall> ui_draw_calls;
-    static inline std::vector<PixelDrawCall> pixel_draw_calls;
     static inline std::vector<TileDrawCall> tile_draw_calls;
+
+    // Per-pass draw order: sorting_order (biased to unsigned) in the high 32 bits, draw call index in the low 32
+    static inline std::vector<uint64_t> sort_keys;
+    static inline std::vector<uint64_t> sort_scratch;
+
+    static auto RadixSortKeys() -> void;
+
+    // Fills sort_keys with the draw calls' stable order by sorting_order
+    template <typename DrawCall>
+    static inline auto SortDrawCalls(const std::vector<DrawCall> &draw_calls) -> void {
+        sort_keys.clear();
+        for (auto i = size_t{0}; i < draw_calls.size(); ++i) {
+            const auto biased_order = static_cast<uint32_t>(draw_calls[i].sorting_order) ^ 0x80000000u;
+            sort_keys.push_back(static_cast<uint64_t>(biased_order) << 32 | static_cast<uint32_t>(i));
+        }
+        if (sort_keys.size() > 1) {
+            RadixSortKeys();
+        }
+    }
 };
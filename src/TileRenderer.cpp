@@ -0,0 +1,120 @@
+#include "TileRenderer.h"
+
+#include <deque>
+#include <vector>
+
+#include "Engine.h"
+#include "Rigidbody.h"
+#include "TextureDB.h"
+
+auto TileRenderer::OnUpdate() -> void {
+    if (Engine::renderer == nullptr) {
+        return;
+    }
+    auto pos_x = x;
+    auto pos_y = y;
+    auto rot_degrees = 0.0f;
+    if (const auto rb = Rigidbody::FindOnActor(actor); rb != nullptr) {
+        const auto pos = rb->GetPosition();
+        pos_x = pos.x;
+        pos_y = pos.y;
+        rot_degrees = rb->GetRotation();
+    }
+    if (const auto cull_size = GetCullSize(rot_degrees); !Engine::IsVisible(pos_x, pos_y, cull_size.x, cull_size.y)) {
+        return;
+    }
+    if (tileset_handle < 0 || tileset != resolved_tileset) {
+        tileset_handle = TextureDB::GetTextureHandle(tileset);
+        resolved_tileset = tileset;
+    }
+    TextureDB::DrawTileExById(tileset_handle, tx, ty, tw, th, pos_x, pos_y, w, h, rot_degrees, tfx ? -1.0f : 1.0f, tfy ? -1.0f : 1.0f, 0.5f, 0.5f, r, g, b, a, sorting_order);
+}
+
+auto TileRenderer::GetX() const -> float {
+    return x;
+}
+
+auto TileRenderer::SetX(float new_x) -> void {
+    x = new_x;
+    MoveInGrid();
+}
+
+auto TileRenderer::GetY() const -> float {
+    return y;
+}
+
+auto TileRenderer::SetY(float new_y) -> void {
+    y = new_y;
+    MoveInGrid();
+}
+
+auto TileRenderer::GetW() const -> float {
+    return w;
+}
+
+auto TileRenderer::SetW(float new_w) -> void {
+    w = new_w;
+    MoveInGrid();
+}
+
+auto TileRenderer::GetH() const -> float {
+    return h;
+}
+
+auto TileRenderer::SetH(float new_h) -> void {
+    h = new_h;
+    MoveInGrid();
+}
+
+auto TileRenderer::GetBounds(void *tile_renderer, glm::vec2 &min, glm::vec2 &max) -> bool {
+    if (Engine::renderer == nullptr) {
+        return false;
+    }
+    const auto renderer = static_cast<TileRenderer *>(tile_renderer);
+    const auto half_size = renderer->GetCullSize(0.0f) * 0.5f;
+    min = glm::vec2(renderer->x, renderer->y) - half_size;
+    max = glm::vec2(renderer->x, renderer->y) + half_size;
+    return true;
+}
+
+auto TileRenderer::Update(void *tile_renderer) -> void {
+    static_cast<TileRenderer *>(tile_renderer)->OnUpdate();
+}
+
+auto TileRenderer::GetCullSize(float rot_degrees) const -> glm::vec2 {
+    const auto size = glm::abs(glm::vec2(w, h)) / static_cast<float>(Engine::config.pixels_per_meter);
+    if (rot_degrees != 0.0f) {
+        return glm::vec2(glm::length(size));
+    }
+    return size;
+}
+
+auto TileRenderer::MoveInGrid() -> void {
+    Engine::scene.render_grid.Refresh(this);
+}
+
+auto TileRenderer::GetActor() const -> ActorHandle {
+    return ActorStore::GetHandle(actor);
+}
+
+static std::deque<TileRenderer> tr_storage;
+static std::vector<TileRenderer *> tr_free;
+// What stale Lua references to recycled instances point at from then on
+static TileRenderer tr_detached;
+
+auto TileRenderer::MakeTileRenderer() -> TileRenderer * {
+    if (!tr_free.empty()) {
+        const auto instance = tr_free.back();
+        tr_free.pop_back();
+        return instance;
+    }
+    tr_storage.push_back(TileRenderer{});
+    return &tr_storage.back();
+}
+
+auto TileRenderer::Recycle(void *tile_renderer) -> void * {
+    const auto instance = static_cast<TileRenderer *>(tile_renderer);
+    *instance = TileRenderer{};
+    tr_free.push_back(instance);
+    return &tr_detached;
+}
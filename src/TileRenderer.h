@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+
+#include "glm/glm.hpp"
+
+#include "ActorStore.h"
+
+class TileRenderer {
+  public:
+    std::string tileset = "???";
+    float x = 0.0f;
+    float y = 0.0f;
+    float w = 32.0f;
+    float h = 32.0f;
+    float tx = 0.0f;
+    float ty = 0.0f;
+    float tw = 32.0f;
+    float th = 32.0f;
+    bool tfx = false;
+    bool tfy = false;
+    float r = 255.0f;
+    float g = 255.0f;
+    float b = 255.0f;
+    float a = 255.0f;
+    float sorting_order = 0.0f;
+
+    std::string type = "TileRenderer";
+    std::string key;
+    Actor *actor = nullptr;
+    bool enabled = true;
+
+    auto GetActor() const -> ActorHandle;
+
+    auto OnUpdate() -> void;
+
+    // Position and size setters keep the render grid entry in sync
+    auto GetX() const -> float;
+    auto SetX(float) -> void;
+    auto GetY() const -> float;
+    auto SetY(float) -> void;
+    auto GetW() const -> float;
+    auto SetW(float) -> void;
+    auto GetH() const -> float;
+    auto SetH(float) -> void;
+
+    static auto Update(void *) -> void;
+    // Bounds for the scene's render grid, see Component::native_bounds
+    static auto GetBounds(void *, glm::vec2 &, glm::vec2 &) -> bool;
+
+    static auto MakeTileRenderer() -> TileRenderer *;
+
+    // Returns the instance to the pool once its actor is released, see Component::native_recycle
+    static auto Recycle(void *) -> void *;
+
+  private:
+    // World-space size used for culling, grown to the diagonal when rotated
+    auto GetCullSize(float) const -> glm::vec2;
+    auto MoveInGrid() -> void;
+
+    // Texture handle for tileset, looked up again only when the name changes
+    std::string resolved_tileset;
+    int tileset_handle = -1;
+};
@@ -0,0 +1,206 @@
+#include "Tilemap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <unordered_map>
+
+#include "Engine.h"
+#include "EngineUtils.h"
+#include "TextureDB.h"
+
+TilemapLayer::TilemapLayer(const std::string &tileset_name, int tile_size, int layer_width, int layer_height, int layer_alpha, int layer_sorting_order)
+    : tileset(tileset_name), grid_size(tile_size), width(layer_width), height(layer_height), alpha(layer_alpha), sorting_order(layer_sorting_order) {
+    chunks_x = (width + chunk_size - 1) / chunk_size;
+    chunks_y = (height + chunk_size - 1) / chunk_size;
+    cells.resize(static_cast<size_t>(width) * height);
+    chunk_tile_counts.resize(static_cast<size_t>(chunks_x) * chunks_y);
+    chunk_textures.resize(chunk_tile_counts.size(), nullptr);
+}
+
+TilemapLayer::~TilemapLayer() {
+    ReleaseChunks();
+}
+
+auto TilemapLayer::SetTile(int px_x, int px_y, int src_x, int src_y, int flip) -> void {
+    const auto cell_x = px_x / grid_size;
+    const auto cell_y = px_y / grid_size;
+    if (px_x < 0 || px_y < 0 || cell_x >= width || cell_y >= height) {
+        return;
+    }
+    const auto index = cell_y * width + cell_x;
+    const auto cell = TilemapCell{src_x, src_y, flip};
+    if (cells[index].IsEmpty()) {
+        cells[index] = cell;
+    } else {
+        stacked_cells.emplace_back(index, cell);
+    }
+    chunk_tile_counts[(cell_y / chunk_size) * chunks_x + cell_x / chunk_size]++;
+}
+
+auto TilemapLayer::Draw() -> void {
+    if (Engine::renderer == nullptr) {
+        return;
+    }
+    const auto pixels_per_meter = static_cast<float>(Engine::config.pixels_per_meter);
+    const auto zoom_factor = Engine::config.zoom_factor;
+    const auto chunk_px = static_cast<float>(chunk_size * grid_size);
+    const auto camera_px = Engine::camera_position * pixels_per_meter;
+    const auto half_w = Engine::config.window_width * 0.5f / zoom_factor;
+    const auto half_h = Engine::config.window_height * 0.5f / zoom_factor;
+    const auto first_x = std::max(static_cast<int>(std::floor((camera_px.x - half_w) / chunk_px)), 0);
+    const auto first_y = std::max(static_cast<int>(std::floor((camera_px.y - half_h) / chunk_px)), 0);
+    const auto last_x = std::min(static_cast<int>(std::floor((camera_px.x + half_w) / chunk_px)), chunks_x - 1);
+    const auto last_y = std::min(static_cast<int>(std::floor((camera_px.y + half_h) / chunk_px)), chunks_y - 1);
+    for (auto chunk_y = first_y; chunk_y <= last_y; ++chunk_y) {
+        for (auto chunk_x = first_x; chunk_x <= last_x; ++chunk_x) {
+            const auto chunk = chunk_y * chunks_x + chunk_x;
+            if (chunk_tile_counts[chunk] == 0) {
+                continue;
+            }
+            if (chunk_textures[chunk] == nullptr) {
+                chunk_textures[chunk] = BakeChunk(chunk_x, chunk_y);
+            }
+            const auto center_x = (chunk_x + 0.5f) * chunk_px / pixels_per_meter;
+            const auto center_y = (chunk_y + 0.5f) * chunk_px / pixels_per_meter;
+            TextureDB::DrawTileTexture(chunk_textures[chunk], center_x, center_y, chunk_px, chunk_px, static_cast<float>(alpha), static_cast<float>(sorting_order));
+        }
+    }
+}
+
+auto TilemapLayer::ReleaseChunks() -> void {
+    for (auto &texture : chunk_textures) {
+        if (texture != nullptr) {
+            SDL_DestroyTexture(texture);
+            texture = nullptr;
+        }
+    }
+}
+
+auto TilemapLayer::GetOutlines() -> const std::vector<std::vector<glm::ivec2>> & {
+    if (outlines_traced) {
+        return outlines;
+    }
+    outlines_traced = true;
+    // Every cell side facing an empty cell, keyed by its starting corner
+    auto edges = std::unordered_map<uint64_t, std::vector<glm::ivec2>>();
+    auto edge_starts = std::vector<glm::ivec2>();
+    const auto add_edge = [&edges, &edge_starts](glm::ivec2 start, glm::ivec2 dir) {
+        edges[EngineUtils::PackIVec(start)].push_back(dir);
+        edge_starts.push_back(start);
+    };
+    for (auto y = 0; y < height; ++y) {
+        for (auto x = 0; x < width; ++x) {
+            if (!IsOccupied(x, y)) {
+                continue;
+            }
+            if (!IsOccupied(x, y - 1)) {
+                add_edge({x, y}, {1, 0});
+            }
+            if (!IsOccupied(x + 1, y)) {
+                add_edge({x + 1, y}, {0, 1});
+            }
+            if (!IsOccupied(x, y + 1)) {
+                add_edge({x + 1, y + 1}, {-1, 0});
+            }
+            if (!IsOccupied(x - 1, y)) {
+                add_edge({x, y + 1}, {0, -1});
+            }
+        }
+    }
+    for (const auto &start : edge_starts) {
+        if (edges[EngineUtils::PackIVec(start)].empty()) {
+            continue;
+        }
+        auto outline = std::vector<glm::ivec2>();
+        auto corner = start;
+        auto dir = glm::ivec2(0, 0);
+        auto first_dir = glm::ivec2(0, 0);
+        do {
+            auto &outgoing = edges[EngineUtils::PackIVec(corner)];
+            // Where two cells touch diagonally, turn toward the solid side so each region closes its own loop
+            const auto right_turn = glm::ivec2(-dir.y, dir.x);
+            auto next = outgoing.begin();
+            for (auto it = outgoing.begin(); it != outgoing.end(); ++it) {
+                if (*it == right_turn) {
+                    next = it;
+                }
+            }
+            const auto next_dir = *next;
+            outgoing.erase(next);
+            if (next_dir != dir) {
+                outline.push_back(corner);
+            }
+            if (dir == glm::ivec2(0, 0)) {
+                first_dir = next_dir;
+            }
+            dir = next_dir;
+            corner += next_dir;
+        } while (corner != start);
+        // The start corner is only a vertex if the outline turns there
+        if (dir == first_dir) {
+            outline.erase(outline.begin());
+        }
+        outlines.push_back(std::move(outline));
+    }
+    return outlines;
+}
+
+auto TilemapLayer::IsOccupied(int x, int y) const -> bool {
+    return x >= 0 && y >= 0 && x < width && y < height && !cells[y * width + x].IsEmpty();
+}
+
+auto TilemapLayer::BakeChunk(int chunk_x, int chunk_y) -> SDL_Texture * {
+    const auto chunk_px = chunk_size * grid_size;
+    const auto texture = SDL_CreateTexture(Engine::renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, chunk_px, chunk_px);
+    if (texture == nullptr) {
+        std::cout << "error: failed to create tilemap chunk " << SDL_GetError();
+        exit(0);
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    const auto tileset_region = TextureDB::GetLoadedTexture(tileset);
+    const auto tileset_texture = tileset_region.texture;
+    auto tileset_blend_mode = SDL_BLENDMODE_BLEND;
+    SDL_GetTextureBlendMode(tileset_texture, &tileset_blend_mode);
+    SDL_SetRenderTarget(Engine::renderer, texture);
+    SDL_RenderSetScale(Engine::renderer, 1, 1);
+    SDL_SetRenderDrawColor(Engine::renderer, 0, 0, 0, 0);
+    SDL_RenderClear(Engine::renderer);
+    const auto start_x = chunk_x * chunk_size;
+    const auto start_y = chunk_y * chunk_size;
+    const auto end_x = std::min(start_x + chunk_size, width);
+    const auto end_y = std::min(start_y + chunk_size, height);
+    // Base tiles never overlap, so copying them unblended keeps their alpha exact
+    SDL_SetTextureBlendMode(tileset_texture, SDL_BLENDMODE_NONE);
+    for (auto y = start_y; y < end_y; ++y) {
+        for (auto x = start_x; x < end_x; ++x) {
+            if (const auto &cell = cells[y * width + x]; !cell.IsEmpty()) {
+                CopyTile(tileset_region, x - start_x, y - start_y, cell);
+            }
+        }
+    }
+    SDL_SetTextureBlendMode(tileset_texture, SDL_BLENDMODE_BLEND);
+    for (const auto &[index, cell] : stacked_cells) {
+        const auto x = index % width;
+        const auto y = index / width;
+        if (x >= start_x && x < end_x && y >= start_y && y < end_y) {
+            CopyTile(tileset_region, x - start_x, y - start_y, cell);
+        }
+    }
+    SDL_SetTextureBlendMode(tileset_texture, tileset_blend_mode);
+    SDL_SetRenderTarget(Engine::renderer, nullptr);
+    return texture;
+}
+
+auto TilemapLayer::CopyTile(const TextureDB::LoadedTexture &tileset_region, int x, int y, const TilemapCell &cell) const -> void {
+    const auto src_rect = SDL_Rect{tileset_region.x + cell.src_x, tileset_region.y + cell.src_y, grid_size, grid_size};
+    const auto dest_rect = SDL_Rect{x * grid_size, y * grid_size, grid_size, grid_size};
+    auto flip_mode = static_cast<int>(SDL_FLIP_NONE);
+    if (cell.flip & 1) {
+        flip_mode |= SDL_FLIP_HORIZONTAL;
+    }
+    if (cell.flip & 2) {
+        flip_mode |= SDL_FLIP_VERTICAL;
+    }
+    SDL_RenderCopyEx(Engine::renderer, tileset_region.texture, &src_rect, &dest_rect, 0, nullptr, static_cast<SDL_RendererFlip>(flip_mode));
+}
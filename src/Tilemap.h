@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "SDL.h"
+
+#include "TextureDB.h"
+
+class TilemapCell {
+  public:
+    int src_x = -1;
+    int src_y = -1;
+    int flip = 0;
+
+    inline auto IsEmpty() const -> bool {
+        return src_x < 0;
+    }
+};
+
+// A tile layer stored as a dense grid and drawn as cached chunk textures
+class TilemapLayer {
+  public:
+    // Chunk edge length, in tiles
+    static constexpr int chunk_size = 16;
+
+    TilemapLayer(const std::string &, int, int, int, int, int);
+
+    ~TilemapLayer();
+
+    TilemapLayer(const TilemapLayer &) = delete;
+    auto operator=(const TilemapLayer &) -> TilemapLayer & = delete;
+
+    // Places a tile at a pixel position within the layer, stacking over any tile already there
+    auto SetTile(int, int, int, int, int) -> void;
+
+    // Queues the chunks that intersect the camera, baking any that have not been drawn yet
+    auto Draw() -> void;
+
+    // Destroys the baked chunk textures; Draw bakes them again as they come into view
+    auto ReleaseChunks() -> void;
+
+    // Closed outlines around the occupied cells, in cell corners, wound so that the solid side is on the right
+    auto GetOutlines() -> const std::vector<std::vector<glm::ivec2>> &;
+
+    inline auto GetGridSize() const -> int {
+        return grid_size;
+    }
+
+  private:
+    std::string tileset;
+    int grid_size;
+    int width;
+    int height;
+    int chunks_x;
+    int chunks_y;
+    int alpha;
+    int sorting_order;
+    std::vector<TilemapCell> cells;
+    // Tiles placed over an occupied cell, in the order LDtk draws them
+    std::vector<std::pair<int, TilemapCell>> stacked_cells;
+    std::vector<int> chunk_tile_counts;
+    std::vector<SDL_Texture *> chunk_textures;
+    bool outlines_traced = false;
+    std::vector<std::vector<glm::ivec2>> outlines;
+
+    auto IsOccupied(int, int) const -> bool;
+
+    auto BakeChunk(int, int) -> SDL_Texture *;
+
+    auto CopyTile(const TextureDB::LoadedTexture &, int, int, const TilemapCell &) const -> void;
+};
@@ -0,0 +1,73 @@
+#include "TilemapCollider.h"
+
+#include <deque>
+#include <vector>
+
+#include "Engine.h"
+#include "Physics.h"
+#include "Rigidbody.h"
+
+auto TilemapCollider::OnStart() -> void {
+    auto def = b2BodyDef{};
+    def.type = b2_staticBody;
+    auto &world = Physics::GetWorld();
+    body = world.CreateBody(&def);
+    if (layer == nullptr) {
+        return;
+    }
+    const auto meters_per_cell = layer->GetGridSize() / static_cast<float>(Engine::config.pixels_per_meter);
+    auto vertices = std::vector<b2Vec2>();
+    for (const auto &outline : layer->GetOutlines()) {
+        vertices.clear();
+        for (const auto &corner : outline) {
+            vertices.emplace_back(corner.x * meters_per_cell, corner.y * meters_per_cell);
+        }
+        auto chain_shape = b2ChainShape{};
+        chain_shape.CreateLoop(vertices.data(), static_cast<int32>(vertices.size()));
+        auto fixture_def = b2FixtureDef{};
+        fixture_def.shape = &chain_shape;
+        fixture_def.friction = friction;
+        fixture_def.restitution = bounciness;
+        fixture_def.filter.categoryBits = RB_COLLIDER;
+        fixture_def.filter.maskBits = RB_COLLIDER;
+        fixture_def.userData.pointer = static_cast<uintptr_t>(actor->store_slot) + 1;
+        body->CreateFixture(&fixture_def);
+    }
+}
+
+auto TilemapCollider::OnDestroy() -> void {
+    if (body != nullptr) {
+        Physics::GetWorld().DestroyBody(body);
+        body = nullptr;
+    }
+}
+
+auto TilemapCollider::GetActor() const -> ActorHandle {
+    return ActorStore::GetHandle(actor);
+}
+
+static std::deque<TilemapCollider> tc_storage;
+static std::vector<TilemapCollider *> tc_free;
+// What stale Lua references to recycled instances point at from then on
+static TilemapCollider tc_detached;
+
+auto TilemapCollider::MakeTilemapCollider() -> TilemapCollider * {
+    if (!tc_free.empty()) {
+        const auto instance = tc_free.back();
+        tc_free.pop_back();
+        return instance;
+    }
+    tc_storage.push_back(TilemapCollider{});
+    return &tc_storage.back();
+}
+
+auto TilemapCollider::Recycle(void *tilemap_collider) -> void * {
+    const auto instance = static_cast<TilemapCollider *>(tilemap_collider);
+    // OnDestroy clears the body, so one left here belongs to an instance whose OnDestroy never ran
+    if (instance->body != nullptr) {
+        Physics::GetWorld().DestroyBody(instance->body);
+    }
+    *instance = TilemapCollider{};
+    tc_free.push_back(instance);
+    return &tc_detached;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "box2d/box2d.h"
+
+#include "ActorStore.h"
+#include "Tilemap.h"
+
+// Static collision for a whole tile layer, built from its outlines as chain loops on one body
+class TilemapCollider {
+  public:
+    float friction = 0.3f;
+    float bounciness = 0.3f;
+    std::shared_ptr<TilemapLayer> layer;
+
+    std::string type = "TilemapCollider";
+    std::string key;
+    Actor *actor = nullptr;
+    bool enabled = true;
+
+    auto GetActor() const -> ActorHandle;
+
+    auto OnStart() -> void;
+
+    auto OnDestroy() -> void;
+
+    inline auto GetBody() const -> const b2Body * {
+        return body;
+    }
+
+    static auto MakeTilemapCollider() -> TilemapCollider *;
+
+    // Returns the instance to the pool once its actor is released, see Component::native_recycle
+    static auto Recycle(void *) -> void *;
+
+  private:
+    b2Body *body = nullptr;
+};